@@ -0,0 +1,112 @@
+// Measures the batch operations of Math.h. The Makefile builds this program
+// twice: normally (SSE paths) and with __SSE__ and __AVX__ undefined (scalar
+// fallback), so the two outputs can be compared.
+//
+// Usage: MathBench [-n count]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "Math.h"
+
+using namespace bdEngine;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Total number of elements processed per operation (repeating the batch)
+const std::size_t elementsPerRun = 1 << 24;
+
+// Runs op on batches until elementsPerRun elements are processed and prints
+// the time per element
+template <class Op>
+void measure(const char* name, std::size_t count, Op op) {
+	std::size_t repeats = std::max<std::size_t>(elementsPerRun / count, 1);
+	
+	// Warm up
+	op();
+	
+	Clock::time_point start = Clock::now();
+	for (std::size_t i = 0; i < repeats; ++i) {
+		op();
+	}
+	std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+	
+	std::cout << "  " << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(3)
+		<< std::setw(10) << elapsed.count() / (repeats * count) << " ns/element" << std::endl;
+}
+
+// Some matrix that is neither the identity nor a pure scaling
+Mat4 makeMatrix(float seed) {
+	Mat4 m;
+	for (int i = 0; i < 16; ++i) {
+		m.m[i] = 0.25f * ((i * 7 + static_cast<int>(seed * 13.0f)) % 11) - 1.0f;
+	}
+	return m;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char* argv[]) {
+	std::size_t count = 4096;
+	if (argc == 3 && std::strcmp(argv[1], "-n") == 0) {
+		count = std::max(std::atoi(argv[2]), 1);
+	}
+	else if (argc != 1) {
+		std::cerr << "Usage: " << argv[0] << " [-n count]" << std::endl;
+		return 1;
+	}
+
+#if defined(__AVX__)
+	std::cout << "Math batch operations (AVX), " << count << " elements per batch" << std::endl;
+#elif defined(__SSE__)
+	std::cout << "Math batch operations (SSE), " << count << " elements per batch" << std::endl;
+#else
+	std::cout << "Math batch operations (scalar), " << count << " elements per batch" << std::endl;
+#endif
+
+	Mat4 a = makeMatrix(0.5f);
+	std::vector<Vec3> points (count);
+	std::vector<Vec3> transformedPoints (count);
+	std::vector<Vec4> vectors (count);
+	std::vector<Vec4> transformedVectors (count);
+	std::vector<Mat4> matricesA (count);
+	std::vector<Mat4> matricesB (count);
+	std::vector<Mat4> products (count);
+	
+	for (std::size_t i = 0; i < count; ++i) {
+		float f = static_cast<float>(i);
+		points[i] = Vec3 {f, -0.5f * f, 2.0f};
+		vectors[i] = Vec4 {f, 1.0f, -f, 1.0f};
+		matricesA[i] = makeMatrix(f);
+		matricesB[i] = makeMatrix(f + 0.25f);
+	}
+	
+	measure("transformPoints", count, [&]() {
+		transformPoints(a, points.data(), transformedPoints.data(), count);
+	});
+	measure("transformVectors", count, [&]() {
+		transformVectors(a, vectors.data(), transformedVectors.data(), count);
+	});
+	measure("multiplyMatrices (one * many)", count, [&]() {
+		multiplyMatrices(a, matricesB.data(), products.data(), count);
+	});
+	measure("multiplyMatrices (pairwise)", count, [&]() {
+		multiplyMatrices(matricesA.data(), matricesB.data(), products.data(), count);
+	});
+	
+	// Use the results, so none of the work can be optimized away
+	float checksum = 0.0f;
+	for (std::size_t i = 0; i < count; ++i) {
+		checksum += transformedPoints[i].x + transformedVectors[i].y + products[i].m[5];
+	}
+	std::cout << "  (checksum " << checksum << ")" << std::endl;
+	
+	return 0;
+}
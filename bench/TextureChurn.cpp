@@ -0,0 +1,97 @@
+// Loads and evicts a set of textures over and over again, the way
+// TextureManager does under memory pressure, once with HeapImageAllocator and
+// once with PooledImageAllocator. Only the CPU side (decoding and mip chain
+// generation) is measured, no GL context is needed.
+//
+// Usage: TextureChurn <image files...> [-n cycles]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Image.h"
+#include "ImageAllocator.h"
+#include "MemoryStats.h"
+#include "MipChain.h"
+
+using namespace bdEngine;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Loads all files, keeps them "resident" until all are loaded, evicts them
+// and repeats. Prints the time and the number of new image allocations per
+// cycle (blocks reused from a pool are not counted, pixels decoded by SOIL
+// always are).
+void runChurn(const char* name, ImageAllocator& allocator, const std::vector<std::string>& filenames, int cycles) {
+	std::vector<std::unique_ptr<MipChain>> resident;
+	
+	// Warm up (and fill the pool)
+	for (const std::string& filename : filenames) {
+		Image image {filename.c_str(), allocator};
+		resident.push_back(std::make_unique<MipChain>(image, MipFilter::Box, nullptr, allocator));
+	}
+	resident.clear();
+	
+	std::size_t allocationsBefore = getMemoryStats(MemoryTag::Image).totalCount;
+	Clock::time_point start = Clock::now();
+	
+	for (int cycle = 0; cycle < cycles; ++cycle) {
+		for (const std::string& filename : filenames) {
+			Image image {filename.c_str(), allocator};
+			resident.push_back(std::make_unique<MipChain>(image, MipFilter::Box, nullptr, allocator));
+		}
+		resident.clear();
+	}
+	
+	std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+	std::size_t allocations = getMemoryStats(MemoryTag::Image).totalCount - allocationsBefore;
+	
+	std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(3)
+		<< std::setw(10) << elapsed.count() / cycles << " ms/cycle"
+		<< std::setw(10) << static_cast<double>(allocations) / cycles << " allocations/cycle" << std::endl;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char* argv[]) {
+	std::vector<std::string> filenames;
+	int cycles = 50;
+	
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+			cycles = std::max(std::atoi(argv[++i]), 1);
+		}
+		else {
+			filenames.push_back(argv[i]);
+		}
+	}
+	if (filenames.empty()) {
+		std::cerr << "Usage: " << argv[0] << " <image files...> [-n cycles]" << std::endl;
+		return 1;
+	}
+	
+	try {
+		std::cout << filenames.size() << " textures, " << cycles << " load/evict cycles" << std::endl;
+		
+		HeapImageAllocator heapAllocator;
+		runChurn("HeapImageAllocator", heapAllocator, filenames, cycles);
+		
+		PooledImageAllocator pooledAllocator;
+		runChurn("PooledImageAllocator", pooledAllocator, filenames, cycles);
+	}
+	catch (std::exception& e) {
+		std::cerr << "Caught exception: " << e.what() << std::endl;
+		return 1;
+	}
+	
+	return 0;
+}
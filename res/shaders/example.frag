@@ -0,0 +1,13 @@
+#version 330 core
+
+in vec3 fragColor;
+in vec2 fragTexCoord;
+out vec4 color;
+
+uniform sampler2D texSampler1;
+uniform sampler2D texSampler2;
+
+void main() {
+	//color = vec4(0.9, 0.2, 0.6, 1);
+	color = mix(texture(texSampler1, fragTexCoord), texture(texSampler2, fragTexCoord), 0.5);
+}
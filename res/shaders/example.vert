@@ -0,0 +1,25 @@
+#version 330 core
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec3 color;
+layout (location = 2) in vec2 texCoord;
+
+out vec3 fragColor;
+out vec2 fragTexCoord;
+
+layout (std140) uniform FrameData {
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	float time;
+	vec2 viewportSize;
+};
+
+uniform mat4 model;
+
+void main() {
+	gl_Position = viewProjection * model * vec4(position.xyz, 1.0);
+	fragColor = color;
+	// Flip texture coordinates vertically because otherwise textures are upside down.
+	fragTexCoord = vec2(texCoord.x, 1 - texCoord.y);
+}
@@ -0,0 +1,175 @@
+#include "Camera.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace bdEngine {
+
+namespace {
+	// Returns the rotation whose matrix has the given columns
+	Quat quatFromBasis(const Vec3& x, const Vec3& y, const Vec3& z) {
+		float trace = x.x + y.y + z.z;
+		Quat q;
+		if (trace > 0) {
+			float s = 0.5f / std::sqrt(trace + 1.0f);
+			q = Quat {(y.z - z.y) * s, (z.x - x.z) * s, (x.y - y.x) * s, 0.25f / s};
+		}
+		else if (x.x > y.y && x.x > z.z) {
+			float s = 2.0f * std::sqrt(1.0f + x.x - y.y - z.z);
+			q = Quat {0.25f * s, (y.x + x.y) / s, (z.x + x.z) / s, (y.z - z.y) / s};
+		}
+		else if (y.y > z.z) {
+			float s = 2.0f * std::sqrt(1.0f + y.y - x.x - z.z);
+			q = Quat {(y.x + x.y) / s, 0.25f * s, (z.y + y.z) / s, (z.x - x.z) / s};
+		}
+		else {
+			float s = 2.0f * std::sqrt(1.0f + z.z - x.x - y.y);
+			q = Quat {(z.x + x.z) / s, (z.y + y.z) / s, 0.25f * s, (x.y - y.x) / s};
+		}
+		return normalize(q);
+	}
+}
+
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+Camera::Camera() {
+}
+
+
+/*******************************************************************
+ * Projection
+ *******************************************************************/
+
+void Camera::setOrthographic(float height, float zNear, float zFar) {
+	projection_ = Projection::Orthographic;
+	size_ = height;
+	zNear_ = zNear;
+	zFar_ = zFar;
+	dirty_ = true;
+}
+
+void Camera::setPerspective(float fovY, float zNear, float zFar) {
+	projection_ = Projection::Perspective;
+	size_ = fovY;
+	zNear_ = zNear;
+	zFar_ = zFar;
+	dirty_ = true;
+}
+
+void Camera::setViewportSize(int width, int height) {
+	// Minimized windows report a size of 0
+	viewportSize_ = Vec2 {
+		static_cast<float>(width > 0 ? width : 1),
+		static_cast<float>(height > 0 ? height : 1)
+	};
+	dirty_ = true;
+}
+
+
+/*******************************************************************
+ * Position and orientation
+ *******************************************************************/
+
+void Camera::setPosition(const Vec3& position) {
+	position_ = position;
+	dirty_ = true;
+}
+
+void Camera::setRotation(const Quat& rotation) {
+	rotation_ = rotation;
+	dirty_ = true;
+}
+
+void Camera::lookAt(const Vec3& eye, const Vec3& target, const Vec3& up) {
+	// Camera looks along -z, so z points away from the target
+	Vec3 z = normalize(eye - target);
+	Vec3 x = normalize(cross(up, z));
+	Vec3 y = cross(z, x);
+	
+	position_ = eye;
+	rotation_ = quatFromBasis(x, y, z);
+	dirty_ = true;
+}
+
+
+/*******************************************************************
+ * Matrices
+ *******************************************************************/
+
+const Mat4& Camera::getViewMatrix() const {
+	updateMatrices();
+	return view_;
+}
+
+const Mat4& Camera::getProjectionMatrix() const {
+	updateMatrices();
+	return projectionMatrix_;
+}
+
+const Mat4& Camera::getViewProjectionMatrix() const {
+	updateMatrices();
+	return viewProjection_;
+}
+
+Rect Camera::getViewBounds() const {
+	Mat4 inverseViewProjection = inverse(getViewProjectionMatrix());
+	
+	// Intersect the rays through the corners of the screen with z = 0
+	Rect bounds {
+		Vec2 {std::numeric_limits<float>::max(), std::numeric_limits<float>::max()},
+		Vec2 {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()}
+	};
+	for (int corner = 0; corner < 4; ++corner) {
+		float x = (corner & 1 ? 1.0f : -1.0f);
+		float y = (corner & 2 ? 1.0f : -1.0f);
+		Vec4 nearPoint = inverseViewProjection * Vec4 {x, y, -1.0f, 1.0f};
+		Vec4 farPoint = inverseViewProjection * Vec4 {x, y, 1.0f, 1.0f};
+		Vec3 p0 = nearPoint.xyz() / nearPoint.w;
+		Vec3 p1 = farPoint.xyz() / farPoint.w;
+		
+		// Orthographic cameras looking along -z see the same point at
+		// any depth; rays that miss the plane are clamped to the far plane
+		Vec3 p = p1;
+		if (p0.z != p1.z) {
+			float t = p0.z / (p0.z - p1.z);
+			if (t >= 0 && t <= 1) {
+				p = p0 + (p1 - p0) * t;
+			}
+		}
+		
+		bounds.min.x = std::min(bounds.min.x, p.x);
+		bounds.min.y = std::min(bounds.min.y, p.y);
+		bounds.max.x = std::max(bounds.max.x, p.x);
+		bounds.max.y = std::max(bounds.max.y, p.y);
+	}
+	return bounds;
+}
+
+void Camera::updateMatrices() const {
+	if (!dirty_) {
+		return;
+	}
+	
+	// Inverse of the camera placement: undo translation, then rotation
+	view_ = Mat4::rotation(conjugate(rotation_)) * Mat4::translation(-position_);
+	
+	float aspect = viewportSize_.x / viewportSize_.y;
+	if (projection_ == Projection::Orthographic) {
+		float halfHeight = size_ / 2;
+		float halfWidth = halfHeight * aspect;
+		projectionMatrix_ = Mat4::orthographic(-halfWidth, halfWidth, -halfHeight, halfHeight, zNear_, zFar_);
+	}
+	else {
+		projectionMatrix_ = Mat4::perspective(size_, aspect, zNear_, zFar_);
+	}
+	
+	viewProjection_ = projectionMatrix_ * view_;
+	dirty_ = false;
+}
+
+} // end namespace bdEngine
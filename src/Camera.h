@@ -0,0 +1,135 @@
+#ifndef _BDENGINE_CAMERA_H
+#define _BDENGINE_CAMERA_H
+
+#include "Math.h"
+
+namespace bdEngine {
+
+/*!
+ * Kind of projection used by a Camera.
+ */
+enum class Projection {
+	Orthographic,
+	Perspective,
+};
+
+/*!
+ * Camera with a position and orientation in the world and an orthographic
+ * or perspective projection.
+ *
+ * The camera looks along its local -z axis with +y up (OpenGL convention).
+ * View and projection matrices are cached and only recomputed after the
+ * camera has changed.
+ */
+class Camera {
+public:
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates an orthographic camera at the origin that shows the range
+	 * [-1, 1] vertically (and as much horizontally as the aspect ratio of
+	 * the viewport allows).
+	 */
+	Camera();
+	
+	
+	/*******************************************************************
+	 * Projection
+	 *******************************************************************/
+	/*!
+	 * Switches to an orthographic projection showing height world units
+	 * vertically, centered on the camera.
+	 */
+	void setOrthographic(float height, float zNear = -1.0f, float zFar = 1.0f);
+	
+	/*!
+	 * Switches to a perspective projection with a vertical field of view in
+	 * radians.
+	 */
+	void setPerspective(float fovY, float zNear = 0.1f, float zFar = 1000.0f);
+	
+	/*!
+	 * Sets the size of the viewport in pixels (determines the aspect ratio).
+	 */
+	void setViewportSize(int width, int height);
+	
+	Projection getProjection() const {
+		return projection_;
+	}
+	
+	Vec2 getViewportSize() const {
+		return viewportSize_;
+	}
+	
+	
+	/*******************************************************************
+	 * Position and orientation
+	 *******************************************************************/
+	void setPosition(const Vec3& position);
+	void setRotation(const Quat& rotation);
+	
+	/*!
+	 * Moves the camera to eye and turns it towards target.
+	 */
+	void lookAt(const Vec3& eye, const Vec3& target, const Vec3& up = Vec3 {0, 1, 0});
+	
+	const Vec3& getPosition() const {
+		return position_;
+	}
+	
+	const Quat& getRotation() const {
+		return rotation_;
+	}
+	
+	
+	/*******************************************************************
+	 * Matrices
+	 *******************************************************************/
+	/*!
+	 * Returns the matrix transforming world to camera space.
+	 */
+	const Mat4& getViewMatrix() const;
+	
+	/*!
+	 * Returns the matrix transforming camera to clip space.
+	 */
+	const Mat4& getProjectionMatrix() const;
+	
+	/*!
+	 * Returns the product of projection and view matrix.
+	 */
+	const Mat4& getViewProjectionMatrix() const;
+	
+	/*!
+	 * Returns the part of the plane z = 0 that is in view (bounding
+	 * rectangle), e.g. for queries of a SpatialHash or LooseQuadtree.
+	 */
+	Rect getViewBounds() const;
+
+private:
+	// Recomputes the cached matrices if anything changed
+	void updateMatrices() const;
+	
+	// Projection parameters (size is the height for orthographic cameras
+	// and the vertical field of view for perspective cameras)
+	Projection projection_ = Projection::Orthographic;
+	float size_ = 2.0f;
+	float zNear_ = -1.0f;
+	float zFar_ = 1.0f;
+	Vec2 viewportSize_ {1.0f, 1.0f};
+	
+	// Placement in the world
+	Vec3 position_;
+	Quat rotation_;
+	
+	// Cached matrices
+	mutable Mat4 view_;
+	mutable Mat4 projectionMatrix_;
+	mutable Mat4 viewProjection_;
+	mutable bool dirty_ = true;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_CAMERA_H */
@@ -0,0 +1,132 @@
+#include "Culling.h"
+
+#include <cmath>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Frustum
+ *******************************************************************/
+
+Frustum Frustum::fromMatrix(const Mat4& viewProjection) {
+	// Rows of the matrix (Gribb/Hartmann plane extraction)
+	const float* m = viewProjection.m;
+	Vec4 rows[4];
+	for (int i = 0; i < 4; ++i) {
+		rows[i] = Vec4 {m[i], m[4 + i], m[8 + i], m[12 + i]};
+	}
+	
+	const Vec4 planes[6] = {
+		rows[3] + rows[0],  // left
+		rows[3] - rows[0],  // right
+		rows[3] + rows[1],  // bottom
+		rows[3] - rows[1],  // top
+		rows[3] + rows[2],  // near
+		rows[3] - rows[2],  // far
+	};
+	
+	Frustum frustum;
+	for (int i = 0; i < 8; ++i) {
+		if (i < 6) {
+			// Normalize, so that distances are comparable
+			const Vec4& p = planes[i];
+			float invLength = 1.0f / std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+			frustum.nx[i] = p.x * invLength;
+			frustum.ny[i] = p.y * invLength;
+			frustum.nz[i] = p.z * invLength;
+			frustum.d[i] = p.w * invLength;
+		}
+		else {
+			// Padding: everything is in front of this plane
+			frustum.nx[i] = frustum.ny[i] = frustum.nz[i] = 0.0f;
+			frustum.d[i] = 1.0f;
+		}
+	}
+	return frustum;
+}
+
+bool Frustum::intersects(const AABB& box) const {
+	Vec3 c = box.getCenter();
+	Vec3 e = box.getExtents();
+
+#ifdef __SSE__
+	__m128 cx = _mm_set1_ps(c.x), cy = _mm_set1_ps(c.y), cz = _mm_set1_ps(c.z);
+	__m128 ex = _mm_set1_ps(e.x), ey = _mm_set1_ps(e.y), ez = _mm_set1_ps(e.z);
+	__m128 signMask = _mm_set1_ps(-0.0f);
+	
+	for (int i = 0; i < 8; i += 4) {
+		__m128 px = _mm_load_ps(&nx[i]);
+		__m128 py = _mm_load_ps(&ny[i]);
+		__m128 pz = _mm_load_ps(&nz[i]);
+		
+		// Signed distance of the center plus the projected radius of the
+		// box; negative means completely behind the plane
+		__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, cx), _mm_mul_ps(py, cy)),
+			_mm_add_ps(_mm_mul_ps(pz, cz), _mm_load_ps(&d[i])));
+		__m128 radius = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_andnot_ps(signMask, px), ex),
+			_mm_mul_ps(_mm_andnot_ps(signMask, py), ey)),
+			_mm_mul_ps(_mm_andnot_ps(signMask, pz), ez));
+		
+		if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(dist, radius), _mm_setzero_ps())) != 0) {
+			return false;
+		}
+	}
+	return true;
+#else
+	for (int i = 0; i < 6; ++i) {
+		float dist = nx[i] * c.x + ny[i] * c.y + nz[i] * c.z + d[i];
+		float radius = std::fabs(nx[i]) * e.x + std::fabs(ny[i]) * e.y + std::fabs(nz[i]) * e.z;
+		if (dist + radius < 0) {
+			return false;
+		}
+	}
+	return true;
+#endif
+}
+
+
+/*******************************************************************
+ * Batch culling
+ *******************************************************************/
+
+std::size_t cullAABBs(const Frustum& frustum, const AABB* boxes, std::size_t count,
+	std::uint32_t* visible)
+{
+	std::size_t visibleCount = 0;
+	for (std::size_t i = 0; i < count; ++i) {
+		if (frustum.intersects(boxes[i])) {
+			visible[visibleCount++] = static_cast<std::uint32_t>(i);
+		}
+	}
+	return visibleCount;
+}
+
+std::size_t cullAABBs(JobSystem& jobSystem, const Frustum& frustum, const AABB* boxes,
+	std::size_t count, std::uint32_t* visible)
+{
+	// Small inputs are not worth the synchronization
+	const std::size_t grainSize = 2048;
+	if (count <= grainSize) {
+		return cullAABBs(frustum, boxes, count, visible);
+	}
+	
+	// Test in parallel, storing a flag per box in the output array...
+	jobSystem.parallelFor(count, grainSize, [&](std::size_t first, std::size_t last) {
+		for (std::size_t i = first; i < last; ++i) {
+			visible[i] = frustum.intersects(boxes[i]) ? 1 : 0;
+		}
+	});
+	
+	// ...then compact it in place (the write position never passes the
+	// read position)
+	std::size_t visibleCount = 0;
+	for (std::size_t i = 0; i < count; ++i) {
+		if (visible[i]) {
+			visible[visibleCount++] = static_cast<std::uint32_t>(i);
+		}
+	}
+	return visibleCount;
+}
+
+} // end namespace bdEngine
@@ -0,0 +1,55 @@
+#ifndef _BDENGINE_CULLING_H
+#define _BDENGINE_CULLING_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "JobSystem.h"
+#include "Math.h"
+
+namespace bdEngine {
+
+/*!
+ * The six clipping planes of a view-projection matrix.
+ *
+ * Planes are stored as structure of arrays, padded to eight with planes
+ * that never reject anything, so that a box can be tested against four
+ * planes at once. For an orthographic camera the four side planes are the
+ * edges of the screen rectangle.
+ */
+struct Frustum {
+	alignas(16) float nx[8];
+	alignas(16) float ny[8];
+	alignas(16) float nz[8];
+	alignas(16) float d[8];
+	
+	/*!
+	 * Extracts the planes of a view-projection matrix (normals pointing
+	 * inwards).
+	 */
+	static Frustum fromMatrix(const Mat4& viewProjection);
+	
+	/*!
+	 * Returns true if the box is at least partially inside the frustum
+	 * (conservative: boxes near corners may be reported as inside).
+	 */
+	bool intersects(const AABB& box) const;
+};
+
+/*!
+ * Tests count boxes against the frustum and writes the indices of the
+ * visible ones to visible (which has room for count indices), in
+ * increasing order. Returns the number of visible boxes.
+ */
+std::size_t cullAABBs(const Frustum& frustum, const AABB* boxes, std::size_t count,
+	std::uint32_t* visible);
+
+/*!
+ * Like cullAABBs(), but splits large inputs across the job system.
+ */
+std::size_t cullAABBs(JobSystem& jobSystem, const Frustum& frustum, const AABB* boxes,
+	std::size_t count, std::uint32_t* visible);
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_CULLING_H */
@@ -0,0 +1,146 @@
+#include "DebugOverlay.h"
+#include "MemoryStats.h"
+
+#include <algorithm>
+
+namespace bdEngine {
+
+const std::size_t DebugOverlay::historySize;
+
+
+/*******************************************************************
+ * Constants
+ *******************************************************************/
+
+// Pixel of the texture for solid rectangles
+static const GLubyte whitePixel[] = {0xFF, 0xFF, 0xFF, 0xFF};
+
+// Interval between refreshes of the text, in seconds
+static const float textRefreshInterval = 0.25f;
+
+// Layout in pixels
+static const float margin = 8.0f;
+static const float barWidth = 2.0f;
+static const float pixelsPerMillisecond = 3.0f;
+static const float graphMaxMilliseconds = 50.0f;
+static const std::uint32_t textScale = 2;
+
+// Colors (RGBA, red in the lowest byte)
+static const std::uint32_t panelColor = 0xA0000000;
+static const std::uint32_t textColor = 0xFFFFFFFF;
+static const std::uint32_t fastColor = 0xFF40D040;
+static const std::uint32_t slowColor = 0xFF30D0E0;
+static const std::uint32_t tooSlowColor = 0xFF3030E0;
+static const std::uint32_t targetLineColor = 0x80FFFFFF;
+
+// Frame times of 60 and 30 fps in milliseconds
+static const float fastFrameTime = 1000.0f / 60.0f;
+static const float slowFrameTime = 1000.0f / 30.0f;
+
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+DebugOverlay::DebugOverlay() {
+	glGenTextures(1, &whiteTextureID_);
+	glBindTexture(GL_TEXTURE_2D, whiteTextureID_);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, whitePixel);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	trackAllocation(MemoryTag::TextureGPU, sizeof(whitePixel));
+}
+
+// Destructor
+DebugOverlay::~DebugOverlay() {
+	glDeleteTextures(1, &whiteTextureID_);
+	trackDeallocation(MemoryTag::TextureGPU, sizeof(whitePixel));
+}
+
+
+/*******************************************************************
+ * Frame times and text
+ *******************************************************************/
+
+bool DebugOverlay::update(float frameTime) {
+	frameTimes_[next_] = frameTime * 1000.0f;
+	next_ = (next_ + 1) % historySize;
+	count_ = std::min(count_ + 1, historySize);
+	
+	textAge_ += frameTime;
+	if (textAge_ < textRefreshInterval && !text_.empty()) {
+		return false;
+	}
+	textAge_ = 0.0f;
+	return true;
+}
+
+float DebugOverlay::getAverageFrameTime() const {
+	if (count_ == 0) {
+		return 0.0f;
+	}
+	
+	float sum = 0.0f;
+	for (std::size_t i = 0; i < count_; ++i) {
+		sum += frameTimes_[i];
+	}
+	return sum / count_;
+}
+
+float DebugOverlay::getMaxFrameTime() const {
+	return *std::max_element(frameTimes_, frameTimes_ + historySize);
+}
+
+
+/*******************************************************************
+ * Drawing
+ *******************************************************************/
+
+void DebugOverlay::draw(SpriteBatch& batch, Font& font, const Vec2& windowSize) {
+	// -- Text in the top left corner, on a dark panel
+	const TextRun& run = font.layout(text_, textScale);
+	Vec2 textTopLeft {margin, windowSize.y - margin};
+	drawRect(batch, Vec2 {0.0f, textTopLeft.y - run.size.y - margin}, Vec2 {run.size.x + 2 * margin, windowSize.y},
+		panelColor);
+	font.draw(batch, text_, textTopLeft, textScale, textColor);
+	
+	// -- Frame time graph in the bottom left corner, oldest frame first
+	const float graphHeight = graphMaxMilliseconds * pixelsPerMillisecond;
+	drawRect(batch, Vec2 {0.0f, 0.0f}, Vec2 {historySize * barWidth + 2 * margin, graphHeight + 2 * margin},
+		panelColor);
+	
+	for (std::size_t i = 0; i < count_; ++i) {
+		std::size_t index = (next_ + historySize - count_ + i) % historySize;
+		float time = frameTimes_[index];
+		std::uint32_t color = time <= fastFrameTime ? fastColor : (time <= slowFrameTime ? slowColor : tooSlowColor);
+		
+		float x = margin + i * barWidth;
+		float height = std::min(time, graphMaxMilliseconds) * pixelsPerMillisecond;
+		drawRect(batch, Vec2 {x, margin}, Vec2 {x + barWidth, margin + height}, color);
+	}
+	
+	// Lines at 60 and 30 fps
+	for (float target : {fastFrameTime, slowFrameTime}) {
+		float y = margin + target * pixelsPerMillisecond;
+		drawRect(batch, Vec2 {margin, y}, Vec2 {margin + historySize * barWidth, y + 1.0f}, targetLineColor);
+	}
+}
+
+
+/*******************************************************************
+ * Internal helpers
+ *******************************************************************/
+
+void DebugOverlay::drawRect(SpriteBatch& batch, const Vec2& min, const Vec2& max, std::uint32_t color) {
+	SpriteVertex corners[4] = {
+		SpriteVertex {min.x, min.y, 0.0f, 0.0f, 0.0f, color},
+		SpriteVertex {max.x, min.y, 0.0f, 1.0f, 0.0f, color},
+		SpriteVertex {max.x, max.y, 0.0f, 1.0f, 1.0f, color},
+		SpriteVertex {min.x, max.y, 0.0f, 0.0f, 1.0f, color},
+	};
+	batch.drawQuad(whiteTextureID_, corners);
+}
+
+} // end namespace bdEngine
@@ -0,0 +1,97 @@
+#ifndef _BDENGINE_DEBUGOVERLAY_H
+#define _BDENGINE_DEBUGOVERLAY_H
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "Font.h"
+#include "Math.h"
+#include "SpriteBatch.h"
+
+namespace bdEngine {
+
+/*!
+ * Heads-up display with a frame time graph and a block of statistics text.
+ *
+ * The graph shows the last historySize frame times as bars, colored by
+ * whether they hit 60 fps (green), 30 fps (yellow) or neither (red). The
+ * text is provided by the owner and only needs to be rebuilt when update()
+ * asks for it, a few times per second, so that it stays readable and its
+ * layout can be cached.
+ */
+class DebugOverlay {
+public:
+	/*! Number of frames shown in the graph. */
+	static const std::size_t historySize = 240;
+	
+	
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	DebugOverlay();
+	~DebugOverlay();
+	
+	// --- Forbid copy and move operations
+	DebugOverlay(const DebugOverlay& other)            = delete;  // copy constructor
+	DebugOverlay& operator=(const DebugOverlay& other) = delete;  // copy assignment
+	DebugOverlay(DebugOverlay&& other)                 = delete;  // move constructor
+	DebugOverlay& operator=(DebugOverlay&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Frame times and text
+	 *******************************************************************/
+	/*!
+	 * Records the duration of a frame in seconds. Returns true if the text
+	 * should be refreshed with setText().
+	 */
+	bool update(float frameTime);
+	
+	/*!
+	 * Replaces the statistics text.
+	 */
+	void setText(std::string text) {
+		text_ = std::move(text);
+	}
+	
+	/*!
+	 * Returns the average and the longest frame time in the graph, in
+	 * milliseconds.
+	 */
+	float getAverageFrameTime() const;
+	float getMaxFrameTime() const;
+	
+	
+	/*******************************************************************
+	 * Drawing
+	 *******************************************************************/
+	/*!
+	 * Adds the graph and the text to a batch in window pixel coordinates
+	 * (y up, origin at the bottom left).
+	 */
+	void draw(SpriteBatch& batch, Font& font, const Vec2& windowSize);
+
+private:
+	// Adds a solid rectangle
+	void drawRect(SpriteBatch& batch, const Vec2& min, const Vec2& max, std::uint32_t color);
+	
+	// Frame times in milliseconds (ring buffer)
+	float frameTimes_[historySize] = {};
+	std::size_t next_ = 0;
+	std::size_t count_ = 0;
+	
+	// Statistics text and the time since it was refreshed
+	std::string text_;
+	float textAge_ = 0.0f;
+	
+	// White texture for solid rectangles
+	GLuint whiteTextureID_ = 0;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_DEBUGOVERLAY_H */
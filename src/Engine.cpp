@@ -1,9 +1,64 @@
 #include "Engine.h"
+#include "MemoryStats.h"
+#include "RenderStats.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <exception>
+#include <sstream>
+#include <stdexcept>
 
 namespace bdEngine {
 
+const float Engine::fixedTimestep = 1.0f / 60.0f;
+const std::uint32_t Engine::maxTicksPerFrame;
+
+namespace {
+
+// Parses the finite frame rate of at least FramePacer::minFrameRate given for
+// an argument
+float parseFrameRate(const std::string& arg, const std::string& value) {
+	std::size_t length = 0;
+	float frameRate = 0.0f;
+	try {
+		frameRate = std::stof(value, &length);
+	}
+	catch (const std::exception&) {
+		// Reported below
+	}
+	if (length != value.size() || !(frameRate >= FramePacer::minFrameRate) || !std::isfinite(frameRate)) {
+		std::ostringstream message;
+		message << "Invalid frame rate '" << value << "' for " << arg << " (expected a number of at least "
+			<< FramePacer::minFrameRate << ").";
+		throw std::invalid_argument(message.str());
+	}
+	return frameRate;
+}
+
+// Parses the count of at most maxCount given for an argument
+std::size_t parseCount(const std::string& arg, const std::string& value, std::size_t maxCount) {
+	// Digits only (std::stoul would also take signs and leading whitespace)
+	unsigned long count = 0;
+	bool valid = (!value.empty() && value.find_first_not_of("0123456789") == std::string::npos);
+	if (valid) {
+		try {
+			count = std::stoul(value);
+		}
+		catch (const std::exception&) {
+			valid = false;
+		}
+	}
+	if (!valid || count > maxCount) {
+		throw std::invalid_argument("Invalid value '" + value + "' for " + arg + " (expected 0 to "
+			+ std::to_string(maxCount) + ").");
+	}
+	return static_cast<std::size_t>(count);
+}
+
+} // end anonymous namespace
+
+
 /*******************************************************************
  * Construction and destruction
  *******************************************************************/
@@ -16,7 +71,52 @@ Engine::Engine() {
 Engine::Engine(int& argc, char**& argv)
 	: Engine()
 {
-	// TODO Parse application arguments
+	// Take the arguments we know, keep the others
+	int kept = std::min(argc, 1);
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool known = (arg == "--record" || arg == "--replay" || arg == "--pacing" || arg == "--frames-in-flight");
+		if (!known) {
+			argv[kept++] = argv[i];
+			continue;
+		}
+		if (i + 1 >= argc) {
+			throw std::invalid_argument("Missing value after " + arg + ".");
+		}
+		std::string value = argv[++i];
+		
+		if (arg == "--record") {
+			recordFilename_ = value;
+		}
+		else if (arg == "--replay") {
+			replayFilename_ = value;
+		}
+		else if (arg == "--pacing") {
+			// vsync, uncapped, adaptive or a fixed frame rate
+			if (value == "vsync") {
+				pacing_ = FramePacing::VSync;
+			}
+			else if (value == "uncapped") {
+				pacing_ = FramePacing::Uncapped;
+			}
+			else if (value == "adaptive") {
+				pacing_ = FramePacing::AdaptiveVSync;
+			}
+			else {
+				pacing_ = FramePacing::FixedRate;
+				frameRate_ = parseFrameRate(arg, value);
+			}
+		}
+		else {
+			maxFramesInFlight_ = parseCount(arg, value, FramePacer::maxFramesInFlightLimit);
+		}
+	}
+	argc = kept;
+	argv[argc] = nullptr;
+	
+	if (!recordFilename_.empty() && recordFilename_ == replayFilename_) {
+		throw std::invalid_argument("Can't record to the replayed file.");
+	}
 }
 
 
@@ -31,8 +131,31 @@ void Engine::init() {
 		throw std::logic_error("Engine already initialized.");
 	}
 	
+	// Start worker threads
+	jobSystem_ = std::make_unique<JobSystem>();
+	
+	// Create per-frame memory arena
+	frameAllocator_ = std::make_unique<FrameAllocator>();
+	
+	// Create transform hierarchy
+	transformSystem_ = std::make_unique<TransformSystem>(jobSystem_.get());
+	
 	// Create and initialize RenderWindow
-	renderWindow_ = std::make_unique<RenderWindow>();
+	renderWindow_ = std::make_unique<RenderWindow>(*jobSystem_, *frameAllocator_, *transformSystem_, world_);
+	
+	// Apply frame pacing settings
+	FramePacer& framePacer = renderWindow_->getFramePacer();
+	framePacer.setPacing(pacing_, frameRate_);
+	framePacer.setMaxFramesInFlight(maxFramesInFlight_);
+	
+	// Open input replay and recording (a replay keeps its timestep)
+	if (!replayFilename_.empty()) {
+		inputReplay_ = std::make_unique<InputReplay>(replayFilename_.c_str());
+		timestep_ = inputReplay_->getTimestep();
+	}
+	if (!recordFilename_.empty()) {
+		inputRecorder_ = std::make_unique<InputRecorder>(recordFilename_.c_str(), timestep_);
+	}
 	
 	// Initialized!
 	initialized_ = true;
@@ -45,13 +168,72 @@ int Engine::run() {
 		throw std::logic_error("Engine not initialized.");
 	}
 	
+	Renderer& renderer = renderWindow_->getRenderer();
+	auto lastFrameTime = std::chrono::steady_clock::now();
+	
 	// Main loop: exit when window is closed
 	while (renderWindow_->keepRunning()) {
-		// Render the current frame
-		renderWindow_->drawFrame();
+		// Wait for the frame pacer (before timing and input sampling)
+		renderWindow_->waitForFrame();
 		
-		// Poll and handle events, call event handlers, etc.
+		// Time since the last frame
+		auto frameTime = std::chrono::steady_clock::now();
+		std::chrono::duration<float> dt = frameTime - lastFrameTime;
+		lastFrameTime = frameTime;
+		
+		// Poll events, which pushes them into the input queue
 		renderWindow_->handleEvents();
+		frameEvents_.clear();
+		renderWindow_->getInputQueue().consume([this](const InputEvent& event) {
+			frameEvents_.push_back(event);
+		});
+		
+		// Number of simulation ticks in this frame
+		std::uint32_t ticks = 0;
+		if (inputReplay_) {
+			// Replace live input and timing with the recorded ones, stop at
+			// the end of the recording
+			frameEvents_.clear();
+			if (!inputReplay_->readFrame(ticks, frameEvents_)) {
+				renderWindow_->stop();
+				break;
+			}
+		}
+		else {
+			tickAccumulator_ = std::min(tickAccumulator_ + dt.count(), maxTicksPerFrame * timestep_);
+			ticks = std::min(static_cast<std::uint32_t>(tickAccumulator_ / timestep_), maxTicksPerFrame);
+			tickAccumulator_ = std::max(tickAccumulator_ - ticks * timestep_, 0.0f);
+		}
+		
+		if (inputRecorder_) {
+			inputRecorder_->writeFrame(ticks, frameEvents_);
+		}
+		
+		// Apply the input of this frame (recorded window sizes are input
+		// only, the viewport follows the live framebuffer)
+		input_.beginFrame();
+		for (const InputEvent& event : frameEvents_) {
+			input_.handleEvent(event);
+		}
+		renderWindow_->_test_handle_input(input_);
+		
+		// Simulate particles in fixed steps
+		for (std::uint32_t tick = 0; tick < ticks; ++tick) {
+			renderer.updateParticles(timestep_);
+		}
+		tickCount_ += ticks;
+		
+		// Update world matrices of moved objects
+		transformSystem_->update();
+		
+		// Render the current frame (at the simulation time, so that a
+		// replay renders the same frames)
+		renderWindow_->drawFrame(static_cast<float>(static_cast<double>(tickCount_) * timestep_));
+		
+		// Release transient memory of the previous frame
+		frameAllocator_->endFrame();
+		endMemoryStatsFrame();
+		endRenderStatsFrame();
 	}
 	
 	return 0;
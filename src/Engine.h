@@ -1,12 +1,33 @@
 #ifndef _BDENGINE_ENGINE_H
 #define _BDENGINE_ENGINE_H
 
+#include "FrameAllocator.h"
+#include "FramePacer.h"
+#include "InputRecording.h"
+#include "InputState.h"
+#include "JobSystem.h"
 #include "RenderWindow.h"
+#include "TransformSystem.h"
+#include "World.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace bdEngine {
 
 class Engine {
 public:
+	/*! Default simulation timestep in seconds. */
+	static const float fixedTimestep;
+	
+	/*! Maximum number of simulation ticks per frame (when the frames are
+	 *  slower, the simulation slows down instead of falling further behind). */
+	static const std::uint32_t maxTicksPerFrame = 8;
+	
+	
 	/*******************************************************************
 	 * Construction and destruction
 	 *******************************************************************/
@@ -22,6 +43,17 @@ public:
  	 * default constructor does. See Engine().
  	 * (May alter argc and argv.)
  	 *
+ 	 * Recognized arguments (removed from argv):
+ 	 *   --record FILE  record the input of the session to FILE
+ 	 *   --replay FILE  replay the input recorded in FILE instead of live
+ 	 *                  input, and stop at its end
+ 	 *   --pacing MODE  frame pacing: vsync (default), uncapped, adaptive
+ 	 *                  or a fixed frame rate in frames per second
+ 	 *   --frames-in-flight N
+ 	 *                  let the GPU lag behind by at most N frames (lower
+ 	 *                  input latency, less throughput)
+ 	 * Throws std::invalid_argument if a value is missing or invalid.
+ 	 *
 	 * @param  argc  Reference to application argc.
 	 * @param  argv  Reference to application argv.
 	 */
@@ -56,13 +88,73 @@ public:
 	 * @return  Exit code to be returned by main().
 	 */
 	int run();
+	
+	
+	/*******************************************************************
+	 * Components
+	 *******************************************************************/
+	
+	/*!
+	 * Returns the world containing all entities of the scene.
+	 */
+	World& getWorld() {
+		return world_;
+	}
+	
+	/*!
+	 * Returns the transform hierarchy of the scene.
+	 */
+	TransformSystem& getTransformSystem() {
+		return *transformSystem_;
+	}
+	
+	/*!
+	 * Returns the keyboard, mouse and joystick state of the current frame.
+	 */
+	const InputState& getInput() const {
+		return input_;
+	}
 
 private:
 	// Initialization state
 	bool initialized_ = false;
 	
+	// Component: JobSystem (worker threads shared by all components)
+	std::unique_ptr<JobSystem> jobSystem_;
+	
+	// Component: FrameAllocator (transient memory, reset after every frame)
+	std::unique_ptr<FrameAllocator> frameAllocator_;
+	
+	// Component: World (entities and their components)
+	World world_;
+	
+	// Component: TransformSystem (transform hierarchy, created by init())
+	std::unique_ptr<TransformSystem> transformSystem_;
+	
 	// Component: RenderWindow (contains the Renderer instance)
 	std::unique_ptr<RenderWindow> renderWindow_;
+	
+	// Component: InputState (input of the current frame, fed by the window)
+	InputState input_;
+	
+	// Input recording and replay (opened by init(), if requested)
+	std::string recordFilename_;
+	std::string replayFilename_;
+	std::unique_ptr<InputRecorder> inputRecorder_;
+	std::unique_ptr<InputReplay> inputReplay_;
+	
+	// Input events of the current frame
+	std::vector<InputEvent> frameEvents_;
+	
+	// Frame pacing (applied by init())
+	FramePacing pacing_ = FramePacing::VSync;
+	float frameRate_ = 60.0f;
+	std::size_t maxFramesInFlight_ = 0;
+	
+	// Fixed timestep simulation
+	float timestep_ = fixedTimestep;
+	float tickAccumulator_ = 0.0f;
+	std::uint64_t tickCount_ = 0;
 };
 
 } // end namespace bdEngine
@@ -0,0 +1,347 @@
+#include "Font.h"
+#include "MemoryStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace bdEngine {
+
+const std::uint32_t Font::glyphWidth;
+const std::uint32_t Font::glyphHeight;
+
+
+/*******************************************************************
+ * Constants, font data
+ *******************************************************************/
+
+// Rows of the printable ASCII characters (32 to 126), top row first, the
+// lowest 5 bits of each row are its pixels (most significant bit left).
+// The last row is for descenders.
+static const std::uint8_t builtinGlyphs[95][Font::glyphHeight] = {
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // ' '
+	{0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04, 0x00},  // '!'
+	{0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // '"'
+	{0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A, 0x00},  // '#'
+	{0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04, 0x00},  // '$'
+	{0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03, 0x00},  // '%'
+	{0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D, 0x00},  // '&'
+	{0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // '''
+	{0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02, 0x00},  // '('
+	{0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08, 0x00},  // ')'
+	{0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00, 0x00},  // '*'
+	{0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00, 0x00},  // '+'
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x04, 0x08},  // ','
+	{0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x00},  // '-'
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00},  // '.'
+	{0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00, 0x00},  // '/'
+	{0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E, 0x00},  // '0'
+	{0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00},  // '1'
+	{0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F, 0x00},  // '2'
+	{0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E, 0x00},  // '3'
+	{0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02, 0x00},  // '4'
+	{0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E, 0x00},  // '5'
+	{0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E, 0x00},  // '6'
+	{0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08, 0x00},  // '7'
+	{0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E, 0x00},  // '8'
+	{0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C, 0x00},  // '9'
+	{0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x00, 0x00},  // ':'
+	{0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x08},  // ';'
+	{0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02, 0x00},  // '<'
+	{0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00, 0x00},  // '='
+	{0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08, 0x00},  // '>'
+	{0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04, 0x00},  // '?'
+	{0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E, 0x00},  // '@'
+	{0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11, 0x00},  // 'A'
+	{0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E, 0x00},  // 'B'
+	{0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E, 0x00},  // 'C'
+	{0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C, 0x00},  // 'D'
+	{0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F, 0x00},  // 'E'
+	{0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10, 0x00},  // 'F'
+	{0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F, 0x00},  // 'G'
+	{0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11, 0x00},  // 'H'
+	{0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00},  // 'I'
+	{0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C, 0x00},  // 'J'
+	{0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11, 0x00},  // 'K'
+	{0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F, 0x00},  // 'L'
+	{0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11, 0x00},  // 'M'
+	{0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11, 0x00},  // 'N'
+	{0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00},  // 'O'
+	{0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10, 0x00},  // 'P'
+	{0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D, 0x00},  // 'Q'
+	{0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11, 0x00},  // 'R'
+	{0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E, 0x00},  // 'S'
+	{0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00},  // 'T'
+	{0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00},  // 'U'
+	{0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04, 0x00},  // 'V'
+	{0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A, 0x00},  // 'W'
+	{0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11, 0x00},  // 'X'
+	{0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x00},  // 'Y'
+	{0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F, 0x00},  // 'Z'
+	{0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E, 0x00},  // '['
+	{0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00, 0x00},  // '\\'
+	{0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E, 0x00},  // ']'
+	{0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00},  // '^'
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x00},  // '_'
+	{0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // '`'
+	{0x00, 0x00, 0x0E, 0x01, 0x0F, 0x11, 0x0F, 0x00},  // 'a'
+	{0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1E, 0x00},  // 'b'
+	{0x00, 0x00, 0x0E, 0x10, 0x10, 0x11, 0x0E, 0x00},  // 'c'
+	{0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x0F, 0x00},  // 'd'
+	{0x00, 0x00, 0x0E, 0x11, 0x1F, 0x10, 0x0E, 0x00},  // 'e'
+	{0x06, 0x09, 0x08, 0x1C, 0x08, 0x08, 0x08, 0x00},  // 'f'
+	{0x00, 0x00, 0x0F, 0x11, 0x11, 0x0F, 0x01, 0x0E},  // 'g'
+	{0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11, 0x00},  // 'h'
+	{0x04, 0x00, 0x0C, 0x04, 0x04, 0x04, 0x0E, 0x00},  // 'i'
+	{0x02, 0x00, 0x06, 0x02, 0x02, 0x02, 0x12, 0x0C},  // 'j'
+	{0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12, 0x00},  // 'k'
+	{0x0C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00},  // 'l'
+	{0x00, 0x00, 0x1A, 0x15, 0x15, 0x11, 0x11, 0x00},  // 'm'
+	{0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11, 0x00},  // 'n'
+	{0x00, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E, 0x00},  // 'o'
+	{0x00, 0x00, 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10},  // 'p'
+	{0x00, 0x00, 0x0F, 0x11, 0x11, 0x0F, 0x01, 0x01},  // 'q'
+	{0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10, 0x00},  // 'r'
+	{0x00, 0x00, 0x0F, 0x10, 0x0E, 0x01, 0x1E, 0x00},  // 's'
+	{0x08, 0x08, 0x1C, 0x08, 0x08, 0x09, 0x06, 0x00},  // 't'
+	{0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0D, 0x00},  // 'u'
+	{0x00, 0x00, 0x11, 0x11, 0x11, 0x0A, 0x04, 0x00},  // 'v'
+	{0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0A, 0x00},  // 'w'
+	{0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x00},  // 'x'
+	{0x00, 0x00, 0x11, 0x11, 0x11, 0x0F, 0x01, 0x0E},  // 'y'
+	{0x00, 0x00, 0x1F, 0x02, 0x04, 0x08, 0x1F, 0x00},  // 'z'
+	{0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02, 0x00},  // '{'
+	{0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00},  // '|'
+	{0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08, 0x00},  // '}'
+	{0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00, 0x00},  // '~'
+};
+
+// Laid out texts kept before the cache starts over
+static const std::size_t maxCachedRuns = 1024;
+
+// Space between glyphs in the atlas, against bleeding
+static const std::uint32_t atlasPadding = 1;
+
+
+/*******************************************************************
+ * GlyphAtlas
+ *******************************************************************/
+
+// Constructor
+GlyphAtlas::GlyphAtlas(std::uint32_t width, std::uint32_t height)
+	: width_ {width}
+	, height_ {height}
+{
+	if (width == 0 || height == 0) {
+		throw std::invalid_argument("Glyph atlas must not be empty.");
+	}
+	
+	glGenTextures(1, &textureID_);
+	glBindTexture(GL_TEXTURE_2D, textureID_);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+	
+	// Glyphs are drawn at their rasterized size
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	
+	// Sample as white with the coverage as alpha
+	const GLint swizzle[] = {GL_ONE, GL_ONE, GL_ONE, GL_RED};
+	glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+	
+	glBindTexture(GL_TEXTURE_2D, 0);
+	
+	gpuBytes_ = static_cast<std::size_t>(width) * height;
+	trackAllocation(MemoryTag::TextureGPU, gpuBytes_);
+}
+
+// Destructor
+GlyphAtlas::~GlyphAtlas() {
+	glDeleteTextures(1, &textureID_);
+	trackDeallocation(MemoryTag::TextureGPU, gpuBytes_);
+}
+
+const GlyphAtlas::Region* GlyphAtlas::find(std::uint32_t key) const {
+	auto it = regions_.find(key);
+	return it != regions_.end() ? &it->second : nullptr;
+}
+
+const GlyphAtlas::Region* GlyphAtlas::add(std::uint32_t key, std::uint32_t width, std::uint32_t height,
+	const std::uint8_t* pixels)
+{
+	// Start a new shelf if the glyph doesn't fit into the current one
+	if (cursorX_ + width > width_ || height > shelfHeight_) {
+		if (cursorX_ > 0) {
+			shelfY_ += shelfHeight_ + atlasPadding;
+			cursorX_ = 0;
+			shelfHeight_ = 0;
+		}
+		if (width > width_ || shelfY_ + height > height_) {
+			return nullptr;
+		}
+		shelfHeight_ = std::max(shelfHeight_, height);
+	}
+	
+	// Copy the pixels (rows are not 4 byte aligned)
+	glBindTexture(GL_TEXTURE_2D, textureID_);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, cursorX_, shelfY_, width, height, GL_RED, GL_UNSIGNED_BYTE, pixels);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	
+	// The top row is at shelfY_, the sprite shader flips v
+	Region region;
+	region.uvMin = Vec2 {static_cast<float>(cursorX_) / width_, 1.0f - static_cast<float>(shelfY_ + height) / height_};
+	region.uvMax = Vec2 {static_cast<float>(cursorX_ + width) / width_, 1.0f - static_cast<float>(shelfY_) / height_};
+	cursorX_ += width + atlasPadding;
+	
+	return &(regions_[key] = region);
+}
+
+void GlyphAtlas::clear() {
+	regions_.clear();
+	shelfY_ = 0;
+	shelfHeight_ = 0;
+	cursorX_ = 0;
+}
+
+
+/*******************************************************************
+ * Font: construction
+ *******************************************************************/
+
+// Constructor
+Font::Font(std::uint32_t atlasSize)
+	: atlas_ {atlasSize, atlasSize}
+{
+}
+
+
+/*******************************************************************
+ * Font: text
+ *******************************************************************/
+
+const TextRun& Font::layout(const std::string& text, std::uint32_t scale) {
+	scale = std::max(scale, 1u);
+	
+	RunKey key {text, scale};
+	auto it = runs_.find(key);
+	if (it != runs_.end()) {
+		return it->second;
+	}
+	
+	if (runs_.size() >= maxCachedRuns) {
+		runs_.clear();
+	}
+	
+	TextRun run;
+	if (!layoutRun(text, scale, run)) {
+		// The atlas is full: start over with only the glyphs of this text
+		// (which invalidates all cached runs)
+		atlas_.clear();
+		runs_.clear();
+		layoutRun(text, scale, run);
+	}
+	
+	return runs_.emplace(std::move(key), std::move(run)).first->second;
+}
+
+void Font::draw(SpriteBatch& batch, const std::string& text, const Vec2& position, std::uint32_t scale,
+	std::uint32_t color)
+{
+	const TextRun& run = layout(text, scale);
+	GLuint textureID = atlas_.getTextureID();
+	
+	// Snap to whole pixels, so that glyph pixels map to screen pixels
+	Vec2 origin {std::floor(position.x), std::floor(position.y)};
+	
+	SpriteVertex corners[4];
+	for (const PositionedGlyph& glyph : run.glyphs) {
+		Vec2 min = origin + glyph.min;
+		Vec2 max = origin + glyph.max;
+		const GlyphAtlas::Region& region = glyph.region;
+		corners[0] = SpriteVertex {min.x, min.y, 0.0f, region.uvMin.x, region.uvMin.y, color};
+		corners[1] = SpriteVertex {max.x, min.y, 0.0f, region.uvMax.x, region.uvMin.y, color};
+		corners[2] = SpriteVertex {max.x, max.y, 0.0f, region.uvMax.x, region.uvMax.y, color};
+		corners[3] = SpriteVertex {min.x, max.y, 0.0f, region.uvMin.x, region.uvMax.y, color};
+		batch.drawQuad(textureID, corners);
+	}
+}
+
+
+/*******************************************************************
+ * Font: internal helpers
+ *******************************************************************/
+
+bool Font::layoutRun(const std::string& text, std::uint32_t scale, TextRun& run) {
+	run.glyphs.clear();
+	run.glyphs.reserve(text.size());
+	
+	const float advance = static_cast<float>((glyphWidth + 1) * scale);
+	const float lineHeight = getLineHeight(scale);
+	const Vec2 glyphSize {static_cast<float>(glyphWidth * scale), static_cast<float>(glyphHeight * scale)};
+	
+	bool complete = true;
+	std::size_t column = 0;
+	std::size_t maxColumns = 0;
+	std::size_t lines = 1;
+	for (char c : text) {
+		if (c == '\n') {
+			column = 0;
+			++lines;
+			continue;
+		}
+		
+		std::size_t current = column++;
+		maxColumns = std::max(maxColumns, column);
+		if (c == ' ') {
+			continue;
+		}
+		
+		const GlyphAtlas::Region* region = getGlyph(static_cast<unsigned char>(c), scale);
+		if (region == nullptr) {
+			complete = false;
+			continue;
+		}
+		
+		// Lines go down from the top left corner
+		PositionedGlyph glyph;
+		glyph.min = Vec2 {current * advance, -static_cast<float>(lines - 1) * lineHeight - glyphSize.y};
+		glyph.max = glyph.min + glyphSize;
+		glyph.region = *region;
+		run.glyphs.push_back(glyph);
+	}
+	
+	run.size = Vec2 {maxColumns * advance, lines * lineHeight};
+	return complete;
+}
+
+const GlyphAtlas::Region* Font::getGlyph(unsigned char c, std::uint32_t scale) {
+	if (c < 32 || c > 126) {
+		c = '?';
+	}
+	
+	std::uint32_t key = (scale << 8) | c;
+	const GlyphAtlas::Region* region = atlas_.find(key);
+	if (region != nullptr) {
+		return region;
+	}
+	
+	// Rasterize the glyph, scaling each pixel up to a scale x scale block
+	const std::uint8_t* rows = builtinGlyphs[c - 32];
+	std::uint32_t width = glyphWidth * scale;
+	std::uint32_t height = glyphHeight * scale;
+	glyphPixels_.resize(static_cast<std::size_t>(width) * height);
+	for (std::uint32_t y = 0; y < height; ++y) {
+		std::uint8_t row = rows[y / scale];
+		for (std::uint32_t x = 0; x < width; ++x) {
+			bool set = (row >> (glyphWidth - 1 - x / scale)) & 1;
+			glyphPixels_[y * width + x] = set ? 0xFF : 0x00;
+		}
+	}
+	
+	return atlas_.add(key, width, height, glyphPixels_.data());
+}
+
+} // end namespace bdEngine
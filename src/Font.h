@@ -0,0 +1,198 @@
+#ifndef _BDENGINE_FONT_H
+#define _BDENGINE_FONT_H
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Math.h"
+#include "SpriteBatch.h"
+
+namespace bdEngine {
+
+/*!
+ * Single channel texture that glyphs are rasterized into on demand.
+ *
+ * Glyphs are packed into shelves (rows of the height of the first glyph
+ * placed in them). The texture is sampled as white with the glyph coverage
+ * as alpha, so the sprite shader tints it with the vertex color. When the
+ * atlas is full, clear() starts over, which invalidates all regions handed
+ * out before.
+ */
+class GlyphAtlas {
+public:
+	/*!
+	 * Region of the atlas holding one glyph, as texture coordinates of its
+	 * bottom left and top right corner (for the sprite shader).
+	 */
+	struct Region {
+		Vec2 uvMin;
+		Vec2 uvMax;
+	};
+	
+	
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	GlyphAtlas(std::uint32_t width = 256, std::uint32_t height = 256);
+	~GlyphAtlas();
+	
+	// --- Forbid copy and move operations
+	GlyphAtlas(const GlyphAtlas& other)            = delete;  // copy constructor
+	GlyphAtlas& operator=(const GlyphAtlas& other) = delete;  // copy assignment
+	GlyphAtlas(GlyphAtlas&& other)                 = delete;  // move constructor
+	GlyphAtlas& operator=(GlyphAtlas&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Glyphs
+	 *******************************************************************/
+	/*!
+	 * Returns the region of a glyph added before, or nullptr.
+	 */
+	const Region* find(std::uint32_t key) const;
+	
+	/*!
+	 * Copies a glyph of width x height coverage values (row by row, top
+	 * row first) into the atlas. Returns nullptr if it doesn't fit.
+	 */
+	const Region* add(std::uint32_t key, std::uint32_t width, std::uint32_t height, const std::uint8_t* pixels);
+	
+	/*!
+	 * Removes all glyphs.
+	 */
+	void clear();
+	
+	
+	/*******************************************************************
+	 * Properties
+	 *******************************************************************/
+	GLuint getTextureID() const {
+		return textureID_;
+	}
+
+private:
+	std::uint32_t width_;
+	std::uint32_t height_;
+	
+	// Regions by glyph key
+	std::unordered_map<std::uint32_t, Region> regions_;
+	
+	// Packing state: current shelf and the next free position in it
+	std::uint32_t shelfY_ = 0;
+	std::uint32_t shelfHeight_ = 0;
+	std::uint32_t cursorX_ = 0;
+	
+	// GL texture (GL_R8)
+	GLuint textureID_ = 0;
+	std::size_t gpuBytes_ = 0;
+};
+
+/*!
+ * Glyph of a laid out text, relative to the top left corner of the text.
+ */
+struct PositionedGlyph {
+	Vec2 min;
+	Vec2 max;
+	GlyphAtlas::Region region;
+};
+
+/*!
+ * Text laid out into glyph quads.
+ */
+struct TextRun {
+	std::vector<PositionedGlyph> glyphs;
+	Vec2 size;
+};
+
+/*!
+ * Monospaced bitmap font for debug and UI text (printable ASCII, other
+ * characters are shown as '?').
+ *
+ * Glyphs are rasterized at integer scales into a GlyphAtlas the first time
+ * they are used. Laid out texts are cached, so drawing the same text again
+ * only copies its quads into the sprite batch, and all text is drawn with
+ * the sprite batch's draw calls.
+ */
+class Font {
+public:
+	/*! Size of a glyph cell at scale 1, in pixels. */
+	static const std::uint32_t glyphWidth = 5;
+	static const std::uint32_t glyphHeight = 8;
+	
+	
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	explicit Font(std::uint32_t atlasSize = 256);
+	
+	// --- Forbid copy and move operations
+	Font(const Font& other)            = delete;  // copy constructor
+	Font& operator=(const Font& other) = delete;  // copy assignment
+	Font(Font&& other)                 = delete;  // move constructor
+	Font& operator=(Font&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Text
+	 *******************************************************************/
+	/*!
+	 * Lays out a text at the given scale (y up, lines separated by '\n').
+	 * The result stays valid until the next call.
+	 */
+	const TextRun& layout(const std::string& text, std::uint32_t scale = 1);
+	
+	/*!
+	 * Adds the quads of a text to a sprite batch. position is the top left
+	 * corner of the text, in the batch's (pixel) coordinates with y up.
+	 */
+	void draw(SpriteBatch& batch, const std::string& text, const Vec2& position, std::uint32_t scale = 1,
+		std::uint32_t color = 0xFFFFFFFF);
+	
+	/*!
+	 * Returns the distance between lines at the given scale, in pixels.
+	 */
+	float getLineHeight(std::uint32_t scale = 1) const {
+		return static_cast<float>((glyphHeight + 2) * scale);
+	}
+
+private:
+	// Cache key of a laid out text
+	struct RunKey {
+		std::string text;
+		std::uint32_t scale;
+		
+		bool operator==(const RunKey& other) const {
+			return scale == other.scale && text == other.text;
+		}
+	};
+	
+	struct RunKeyHash {
+		std::size_t operator()(const RunKey& key) const {
+			return std::hash<std::string>()(key.text) ^ (key.scale * 0x9E3779B9u);
+		}
+	};
+	
+	// Lays out a text into run, rasterizing missing glyphs. Returns false
+	// if the atlas ran out of space.
+	bool layoutRun(const std::string& text, std::uint32_t scale, TextRun& run);
+	
+	// Returns the atlas region of a glyph, rasterizing it if needed
+	const GlyphAtlas::Region* getGlyph(unsigned char c, std::uint32_t scale);
+	
+	GlyphAtlas atlas_;
+	
+	// Laid out texts
+	std::unordered_map<RunKey, TextRun, RunKeyHash> runs_;
+	
+	// Scratch memory for rasterizing glyphs
+	std::vector<std::uint8_t> glyphPixels_;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_FONT_H */
@@ -0,0 +1,91 @@
+#include "FrameAllocator.h"
+#include "MemoryStats.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+FrameAllocator::FrameAllocator(std::size_t capacity)
+	: capacity_ {capacity}
+{
+	for (auto& buffer : buffers_) {
+		buffer.memory.reset(new unsigned char[capacity]);
+		buffer.capacity = capacity;
+		trackAllocation(MemoryTag::Frame, capacity);
+	}
+}
+
+// Destructor
+FrameAllocator::~FrameAllocator() {
+	for (auto& buffer : buffers_) {
+		trackDeallocation(MemoryTag::Frame, buffer.capacity);
+	}
+}
+
+
+/*******************************************************************
+ * Allocation
+ *******************************************************************/
+
+void* FrameAllocator::allocate(std::size_t size, std::size_t alignment) {
+	Buffer& buffer = buffers_[current_];
+	
+	// Reserve size plus worst case alignment padding with a single atomic add
+	std::size_t begin = buffer.offset.fetch_add(size + alignment - 1);
+	
+	if (begin + size + alignment - 1 <= buffer.capacity) {
+		std::uintptr_t address = reinterpret_cast<std::uintptr_t>(buffer.memory.get() + begin);
+		address = (address + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+		return reinterpret_cast<void*>(address);
+	}
+	
+	// Buffer is full: take a block from the heap (operator new[] returns
+	// memory aligned for any fundamental type, larger alignments are padded)
+	std::lock_guard<std::mutex> lock {buffer.overflowMutex};
+	buffer.overflow.emplace_back(new unsigned char[size + alignment - 1]);
+	buffer.overflowBytes += size + alignment - 1;
+	
+	std::uintptr_t address = reinterpret_cast<std::uintptr_t>(buffer.overflow.back().get());
+	address = (address + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+	return reinterpret_cast<void*>(address);
+}
+
+void FrameAllocator::endFrame() {
+	// Switch to the other buffer, which holds the data of the previous frame
+	current_ = 1 - current_;
+	Buffer& buffer = buffers_[current_];
+	
+	// If the buffer ran full in its last frame, grow it to what was needed
+	if (!buffer.overflow.empty()) {
+		capacity_ = std::max(capacity_, buffer.capacity + buffer.overflowBytes);
+		buffer.overflow.clear();
+		buffer.overflowBytes = 0;
+	}
+	if (buffer.capacity < capacity_) {
+		buffer.memory.reset(new unsigned char[capacity_]);
+		trackDeallocation(MemoryTag::Frame, buffer.capacity);
+		trackAllocation(MemoryTag::Frame, capacity_);
+		buffer.capacity = capacity_;
+	}
+	
+	buffer.offset = 0;
+}
+
+
+/*******************************************************************
+ * Properties
+ *******************************************************************/
+
+std::size_t FrameAllocator::getUsedBytes() const {
+	const Buffer& buffer = buffers_[current_];
+	std::lock_guard<std::mutex> lock {buffer.overflowMutex};
+	return std::min(buffer.offset.load(), buffer.capacity) + buffer.overflowBytes;
+}
+
+} // end namespace bdEngine
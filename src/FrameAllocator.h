@@ -0,0 +1,181 @@
+#ifndef _BDENGINE_FRAMEALLOCATOR_H
+#define _BDENGINE_FRAMEALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bdEngine {
+
+/*!
+ * Linear (bump pointer) allocator for transient per-frame data.
+ *
+ * Allocating is a single atomic add on an offset into a preallocated buffer,
+ * there is no per-allocation bookkeeping and nothing is freed individually.
+ * Instead, the whole buffer is reset at once. The allocator is double
+ * buffered: memory allocated during frame N stays valid until endFrame() is
+ * called at the end of frame N+1, so data prepared while updating one frame
+ * can still be used while rendering the next one.
+ *
+ * allocate() may be called from any thread, endFrame() only while no other
+ * thread is allocating. If a frame needs more memory than the buffer
+ * capacity, the excess is taken from the heap and the buffer grows on the
+ * next reset.
+ *
+ * Destructors of objects created in frame memory are never called.
+ */
+class FrameAllocator {
+public:
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates the allocator with two buffers of the given size in bytes.
+	 */
+	explicit FrameAllocator(std::size_t capacity = 4 * 1024 * 1024);
+	
+	/*!
+	 * Releases both buffers.
+	 */
+	~FrameAllocator();
+	
+	// --- Forbid copy and move operations
+	FrameAllocator(const FrameAllocator& other)            = delete;  // copy constructor
+	FrameAllocator& operator=(const FrameAllocator& other) = delete;  // copy assignment
+	FrameAllocator(FrameAllocator&& other)                 = delete;  // move constructor
+	FrameAllocator& operator=(FrameAllocator&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Allocation
+	 *******************************************************************/
+	/*!
+	 * Returns size bytes of frame memory with the given alignment (which
+	 * has to be a power of two).
+	 */
+	void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+	
+	/*!
+	 * Returns uninitialized frame memory for count objects of type T.
+	 */
+	template <class T>
+	T* allocateArray(std::size_t count) {
+		return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+	}
+	
+	/*!
+	 * Constructs an object in frame memory. As its destructor will never be
+	 * called, T has to be trivially destructible.
+	 */
+	template <class T, class... Args>
+	T* create(Args&&... args) {
+		static_assert(std::is_trivially_destructible<T>::value,
+			"Objects in frame memory are never destroyed.");
+		return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+	}
+	
+	/*!
+	 * Ends the current frame: switches to the other buffer and resets it,
+	 * releasing everything that was allocated the frame before.
+	 */
+	void endFrame();
+	
+	
+	/*******************************************************************
+	 * Properties
+	 *******************************************************************/
+	/*!
+	 * Returns the number of bytes allocated in the current frame.
+	 */
+	std::size_t getUsedBytes() const;
+	
+	/*!
+	 * Returns the capacity of each of the two buffers in bytes.
+	 */
+	std::size_t getCapacity() const {
+		return capacity_;
+	}
+
+private:
+	// One of the two frame buffers
+	struct Buffer {
+		std::unique_ptr<unsigned char[]> memory;
+		std::size_t capacity = 0;
+		
+		// Next free byte (may exceed capacity, see overflow)
+		std::atomic<std::size_t> offset {0};
+		
+		// Heap blocks used after the buffer ran full, with their total size
+		// (both guarded by overflowMutex)
+		std::vector<std::unique_ptr<unsigned char[]>> overflow;
+		std::size_t overflowBytes = 0;
+		mutable std::mutex overflowMutex;
+	};
+	
+	// Capacity for buffers (re)created on reset
+	std::size_t capacity_;
+	
+	// The two buffers and the index of the current one
+	Buffer buffers_[2];
+	int current_ = 0;
+};
+
+
+/*!
+ * Standard library allocator that takes memory from a FrameAllocator, for
+ * containers and strings that only live during a frame. deallocate() does
+ * nothing, the memory is reclaimed with the frame.
+ */
+template <class T>
+class FrameAllocatorAdapter {
+public:
+	using value_type = T;
+	
+	FrameAllocatorAdapter(FrameAllocator& frameAllocator)
+		: frameAllocator_ {&frameAllocator}
+	{}
+	
+	template <class U>
+	FrameAllocatorAdapter(const FrameAllocatorAdapter<U>& other)
+		: frameAllocator_ {other.getFrameAllocator()}
+	{}
+	
+	T* allocate(std::size_t n) {
+		return frameAllocator_->allocateArray<T>(n);
+	}
+	
+	void deallocate(T* ptr, std::size_t n) {
+	}
+	
+	FrameAllocator* getFrameAllocator() const {
+		return frameAllocator_;
+	}
+
+private:
+	FrameAllocator* frameAllocator_;
+};
+
+template <class T, class U>
+bool operator==(const FrameAllocatorAdapter<T>& a, const FrameAllocatorAdapter<U>& b) {
+	return a.getFrameAllocator() == b.getFrameAllocator();
+}
+
+template <class T, class U>
+bool operator!=(const FrameAllocatorAdapter<T>& a, const FrameAllocatorAdapter<U>& b) {
+	return !(a == b);
+}
+
+// Containers using frame memory
+template <class T>
+using FrameVector = std::vector<T, FrameAllocatorAdapter<T>>;
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocatorAdapter<char>>;
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_FRAMEALLOCATOR_H */
@@ -0,0 +1,152 @@
+#include "FramePacer.h"
+#include "GLFWpp.h"
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace bdEngine {
+
+namespace {
+
+// Time before the start of a frame at which FixedRate stops sleeping and
+// starts spinning
+const std::chrono::microseconds spinTime {1500};
+
+// Maximum time to wait for a single fence (so a lost context can't hang us)
+const GLuint64 fenceTimeout = 1000000000;  // 1 s
+
+} // end anonymous namespace
+
+const std::size_t FramePacer::maxFramesInFlightLimit;
+const float FramePacer::minFrameRate = 1.0f;
+
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+FramePacer::FramePacer() {
+	setPacing(FramePacing::VSync);
+}
+
+// Destructor
+FramePacer::~FramePacer() {
+	setMaxFramesInFlight(0);
+}
+
+
+/*******************************************************************
+ * Settings
+ *******************************************************************/
+
+FramePacing FramePacer::setPacing(FramePacing pacing, float frameRate) {
+	// (Lower rates would overflow the frame period)
+	if (pacing == FramePacing::FixedRate && !(frameRate >= minFrameRate)) {
+		throw std::invalid_argument("Frame rate too low for fixed rate pacing.");
+	}
+	
+	if (pacing == FramePacing::AdaptiveVSync && !GLFW::isExtensionSupported("WGL_EXT_swap_control_tear")
+		&& !GLFW::isExtensionSupported("GLX_EXT_swap_control_tear"))
+	{
+		pacing = FramePacing::VSync;
+	}
+	pacing_ = pacing;
+	
+	switch (pacing) {
+	case FramePacing::VSync:
+		GLFW::setSwapInterval(1);
+		break;
+	
+	case FramePacing::AdaptiveVSync:
+		GLFW::setSwapInterval(-1);
+		break;
+	
+	case FramePacing::FixedRate:
+		framePeriod_ = std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<float> {1.0f / frameRate});
+		nextFrame_ = Clock::now();
+		GLFW::setSwapInterval(0);
+		break;
+	
+	default:
+		GLFW::setSwapInterval(0);
+		break;
+	}
+	return pacing_;
+}
+
+void FramePacer::setMaxFramesInFlight(std::size_t frames) {
+	if (frames > maxFramesInFlightLimit) {
+		throw std::invalid_argument("At most " + std::to_string(maxFramesInFlightLimit) + " frames in flight are supported.");
+	}
+	maxFramesInFlight_ = frames;
+	
+	// Without limit, the fences are not needed anymore (with a lower
+	// limit, waitForFrame() waits for the extra ones)
+	if (maxFramesInFlight_ == 0) {
+		for (std::size_t i = 0; i < fenceCount_; ++i) {
+			glDeleteSync(fences_[(oldestFence_ + i) % maxFramesInFlightLimit]);
+		}
+		oldestFence_ = 0;
+		fenceCount_ = 0;
+	}
+}
+
+
+/*******************************************************************
+ * Pacing
+ *******************************************************************/
+
+void FramePacer::waitForFrame() {
+	// Let the GPU catch up
+	while (maxFramesInFlight_ > 0 && fenceCount_ >= maxFramesInFlight_) {
+		waitForOldestFence();
+	}
+	
+	if (pacing_ != FramePacing::FixedRate) {
+		return;
+	}
+	
+	// Sleep (the OS may oversleep), then spin the rest
+	Clock::time_point now = Clock::now();
+	if (nextFrame_ - now > spinTime) {
+		std::this_thread::sleep_for(nextFrame_ - now - spinTime);
+	}
+	while (Clock::now() < nextFrame_) {
+		std::this_thread::yield();
+	}
+	
+	// Keep the cadence, unless we are a whole frame late
+	nextFrame_ += framePeriod_;
+	now = Clock::now();
+	if (nextFrame_ < now) {
+		nextFrame_ = now + framePeriod_;
+	}
+}
+
+void FramePacer::endFrame() {
+	if (maxFramesInFlight_ == 0) {
+		return;
+	}
+	
+	if (fenceCount_ == maxFramesInFlightLimit) {
+		waitForOldestFence();
+	}
+	
+	std::size_t slot = (oldestFence_ + fenceCount_) % maxFramesInFlightLimit;
+	fences_[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	++fenceCount_;
+}
+
+void FramePacer::waitForOldestFence() {
+	// Flush, so that the fence is submitted at all
+	glClientWaitSync(fences_[oldestFence_], GL_SYNC_FLUSH_COMMANDS_BIT, fenceTimeout);
+	glDeleteSync(fences_[oldestFence_]);
+	fences_[oldestFence_] = nullptr;
+	oldestFence_ = (oldestFence_ + 1) % maxFramesInFlightLimit;
+	--fenceCount_;
+}
+
+} // end namespace bdEngine
@@ -0,0 +1,128 @@
+#ifndef _BDENGINE_FRAMEPACER_H
+#define _BDENGINE_FRAMEPACER_H
+
+// GLEW has to be included *before* GLFW or any other OpenGL header.
+#include <GL/glew.h>
+
+#include <chrono>
+#include <cstddef>
+
+namespace bdEngine {
+
+/*!
+ * How the start of frames is timed.
+ */
+enum class FramePacing {
+	VSync,          // wait for the vertical blank on swap (no tearing)
+	Uncapped,       // swap immediately, as fast as possible
+	AdaptiveVSync,  // vsync, but late frames swap immediately (falls back
+	                // to VSync if the driver doesn't support it)
+	FixedRate,      // no vsync, frames start at a fixed rate
+};
+
+/*!
+ * Paces the frames of a window: sets the swap interval, waits for the start
+ * of the next frame at a fixed frame rate, and limits how many frames the
+ * GPU may lag behind.
+ *
+ * Fixed rate waiting sleeps for most of the time and spins for the rest,
+ * as sleeping alone often overshoots by a millisecond or more. Frames in
+ * flight are limited with a fence after every swap: a new frame only starts
+ * when the frame maxFramesInFlight frames before has been finished by the
+ * GPU. This keeps input from being sampled long before its frame is shown,
+ * at the cost of some throughput.
+ *
+ * Requires a current context.
+ */
+class FramePacer {
+public:
+	/*! Largest supported limit of frames in flight. */
+	static const std::size_t maxFramesInFlightLimit = 8;
+	
+	/*! Lowest supported FixedRate frame rate in frames per second. */
+	static const float minFrameRate;
+	
+	
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates a pacer using VSync and no frames in flight limit.
+	 */
+	FramePacer();
+	~FramePacer();
+	
+	// --- Forbid copy and move operations
+	FramePacer(const FramePacer& other)            = delete;  // copy constructor
+	FramePacer& operator=(const FramePacer& other) = delete;  // copy assignment
+	FramePacer(FramePacer&& other)                 = delete;  // move constructor
+	FramePacer& operator=(FramePacer&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Settings
+	 *******************************************************************/
+	/*!
+	 * Sets the pacing mode and, for FixedRate, the frame rate in frames per
+	 * second. Returns the mode that is actually used. Throws
+	 * std::invalid_argument if the frame rate of FixedRate is below
+	 * minFrameRate.
+	 */
+	FramePacing setPacing(FramePacing pacing, float frameRate = 60.0f);
+	
+	/*!
+	 * Returns the pacing mode in use.
+	 */
+	FramePacing getPacing() const {
+		return pacing_;
+	}
+	
+	/*!
+	 * Sets how many frames may be queued on the GPU, or 0 to leave that to
+	 * the driver. Throws std::invalid_argument if frames is greater than
+	 * maxFramesInFlightLimit.
+	 */
+	void setMaxFramesInFlight(std::size_t frames);
+	
+	/*!
+	 * Returns the limit of frames in flight (0 if there is none).
+	 */
+	std::size_t getMaxFramesInFlight() const {
+		return maxFramesInFlight_;
+	}
+	
+	
+	/*******************************************************************
+	 * Pacing
+	 *******************************************************************/
+	/*!
+	 * Waits until the next frame may start. Call before sampling input.
+	 */
+	void waitForFrame();
+	
+	/*!
+	 * Marks the end of a frame. Call right after swapping buffers.
+	 */
+	void endFrame();
+
+private:
+	using Clock = std::chrono::steady_clock;
+	
+	// Waits for the oldest fence and deletes it
+	void waitForOldestFence();
+	
+	// Mode
+	FramePacing pacing_ = FramePacing::VSync;
+	Clock::duration framePeriod_ {0};
+	Clock::time_point nextFrame_;
+	
+	// Fences of the frames in flight (ring buffer)
+	std::size_t maxFramesInFlight_ = 0;
+	GLsync fences_[maxFramesInFlightLimit] = {};
+	std::size_t oldestFence_ = 0;
+	std::size_t fenceCount_ = 0;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_FRAMEPACER_H */
@@ -0,0 +1,87 @@
+#include "FrameProfiler.h"
+
+namespace bdEngine {
+
+const std::size_t FrameProfiler::latency;
+
+
+/*******************************************************************
+ * Phases
+ *******************************************************************/
+
+const char* getRenderPhaseName(RenderPhase phase) {
+	switch (phase) {
+	case RenderPhase::Scene:      return "Scene";
+	case RenderPhase::Tilemaps:   return "Tilemaps";
+	case RenderPhase::Sprites:    return "Sprites";
+	case RenderPhase::Particles:  return "Particles";
+	case RenderPhase::Overlay:    return "Overlay";
+	default:                      return "?";
+	}
+}
+
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+FrameProfiler::FrameProfiler() {
+	glGenQueries(latency * phaseCount, &queries_[0][0]);
+}
+
+// Destructor
+FrameProfiler::~FrameProfiler() {
+	glDeleteQueries(latency * phaseCount, &queries_[0][0]);
+}
+
+
+/*******************************************************************
+ * Measuring
+ *******************************************************************/
+
+void FrameProfiler::beginFrame() {
+	endPhase();
+	frame_ = (frame_ + 1) % latency;
+	
+	// The queries of this slot were issued latency frames ago: take the
+	// results that are ready, the others are reissued and lost
+	for (std::size_t phase = 0; phase < phaseCount; ++phase) {
+		if (!issued_[frame_][phase]) {
+			continue;
+		}
+		issued_[frame_][phase] = false;
+		
+		GLuint query = queries_[frame_][phase];
+		GLint available = 0;
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available) {
+			GLuint64 nanoseconds = 0;
+			glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+			gpuTimes_[phase] = static_cast<float>(nanoseconds) * 1e-6f;
+		}
+	}
+}
+
+void FrameProfiler::beginPhase(RenderPhase phase) {
+	endPhase();
+	
+	phase_ = static_cast<std::size_t>(phase);
+	inPhase_ = true;
+	phaseStart_ = std::chrono::steady_clock::now();
+	glBeginQuery(GL_TIME_ELAPSED, queries_[frame_][phase_]);
+	issued_[frame_][phase_] = true;
+}
+
+void FrameProfiler::endPhase() {
+	if (!inPhase_) {
+		return;
+	}
+	
+	glEndQuery(GL_TIME_ELAPSED);
+	std::chrono::duration<float, std::milli> time = std::chrono::steady_clock::now() - phaseStart_;
+	cpuTimes_[phase_] = time.count();
+	inPhase_ = false;
+}
+
+} // end namespace bdEngine
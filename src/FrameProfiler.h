@@ -0,0 +1,112 @@
+#ifndef _BDENGINE_FRAMEPROFILER_H
+#define _BDENGINE_FRAMEPROFILER_H
+
+#include <GL/glew.h>
+
+#include <chrono>
+#include <cstddef>
+
+namespace bdEngine {
+
+/*!
+ * Phases of a rendered frame that are timed separately.
+ */
+enum class RenderPhase {
+	Scene,      // clearing, frame uniforms, example object
+	Tilemaps,   // tilemap layers
+	Sprites,    // culling and batching sprites
+	Particles,  // particle systems
+	Overlay,    // text and debug overlay
+	Count
+};
+
+/*!
+ * Returns a human readable name of a phase.
+ */
+const char* getRenderPhaseName(RenderPhase phase);
+
+/*!
+ * Measures the CPU and GPU time of each render phase.
+ *
+ * CPU times are taken with a steady clock. GPU times come from
+ * GL_TIME_ELAPSED queries, which are only read latency frames later (if
+ * the results are available by then), so that the CPU never waits for the
+ * GPU. Phases must not overlap.
+ */
+class FrameProfiler {
+public:
+	/*! Number of frames whose queries are in flight. */
+	static const std::size_t latency = 4;
+	
+	
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	FrameProfiler();
+	~FrameProfiler();
+	
+	// --- Forbid copy and move operations
+	FrameProfiler(const FrameProfiler& other)            = delete;  // copy constructor
+	FrameProfiler& operator=(const FrameProfiler& other) = delete;  // copy assignment
+	FrameProfiler(FrameProfiler&& other)                 = delete;  // move constructor
+	FrameProfiler& operator=(FrameProfiler&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Measuring
+	 *******************************************************************/
+	/*!
+	 * Starts a frame (collects the GPU results of an earlier frame).
+	 */
+	void beginFrame();
+	
+	/*!
+	 * Starts timing a phase, ending the current one.
+	 */
+	void beginPhase(RenderPhase phase);
+	
+	/*!
+	 * Ends the current phase.
+	 */
+	void endPhase();
+	
+	
+	/*******************************************************************
+	 * Results
+	 *******************************************************************/
+	/*!
+	 * Returns the CPU time of a phase in the last frame, in milliseconds.
+	 */
+	float getCPUTime(RenderPhase phase) const {
+		return cpuTimes_[static_cast<std::size_t>(phase)];
+	}
+	
+	/*!
+	 * Returns the GPU time of a phase in the latest frame whose results
+	 * are available, in milliseconds.
+	 */
+	float getGPUTime(RenderPhase phase) const {
+		return gpuTimes_[static_cast<std::size_t>(phase)];
+	}
+
+private:
+	static const std::size_t phaseCount = static_cast<std::size_t>(RenderPhase::Count);
+	
+	// Queries of each frame in flight, by phase
+	GLuint queries_[latency][phaseCount];
+	bool issued_[latency][phaseCount] = {};
+	std::size_t frame_ = 0;
+	
+	// Phase being timed
+	bool inPhase_ = false;
+	std::size_t phase_ = 0;
+	std::chrono::steady_clock::time_point phaseStart_;
+	
+	// Results in milliseconds
+	float cpuTimes_[phaseCount] = {};
+	float gpuTimes_[phaseCount] = {};
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_FRAMEPROFILER_H */
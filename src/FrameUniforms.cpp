@@ -0,0 +1,70 @@
+#include "FrameUniforms.h"
+#include "MemoryStats.h"
+#include "RenderStats.h"
+
+namespace bdEngine {
+
+const GLchar* const FrameUniforms::blockName = "FrameData";
+const GLuint FrameUniforms::bindingPoint;
+
+const GLchar* const FrameUniforms::glslBlock = R"__SRC__(
+#version 330 core
+
+layout (std140) uniform FrameData {
+	mat4 view;
+	mat4 projection;
+	mat4 viewProjection;
+	float time;
+	vec2 viewportSize;
+};
+
+)__SRC__";
+
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+FrameUniforms::FrameUniforms()
+	: data_ {}
+{
+	glGenBuffers(1, &bufferID_);
+	glBindBuffer(GL_UNIFORM_BUFFER, bufferID_);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	trackAllocation(MemoryTag::BufferGPU, sizeof(FrameData));
+	
+	// The binding stays for the lifetime of the buffer
+	glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, bufferID_);
+}
+
+// Destructor
+FrameUniforms::~FrameUniforms() {
+	if (bufferID_) {
+		glDeleteBuffers(1, &bufferID_);
+	}
+	trackDeallocation(MemoryTag::BufferGPU, sizeof(FrameData));
+}
+
+
+/*******************************************************************
+ * Updating
+ *******************************************************************/
+
+void FrameUniforms::update(const Camera& camera, float time) {
+	data_.view = camera.getViewMatrix();
+	data_.projection = camera.getProjectionMatrix();
+	data_.viewProjection = camera.getViewProjectionMatrix();
+	data_.time = time;
+	data_.viewportSize[0] = camera.getViewportSize().x;
+	data_.viewportSize[1] = camera.getViewportSize().y;
+	
+	glBindBuffer(GL_UNIFORM_BUFFER, bufferID_);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &data_);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	countUniformUpload();
+	countUpload(0, sizeof(FrameData));
+}
+
+} // end namespace bdEngine
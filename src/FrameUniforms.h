@@ -0,0 +1,96 @@
+#ifndef _BDENGINE_FRAMEUNIFORMS_H
+#define _BDENGINE_FRAMEUNIFORMS_H
+
+#include <GL/glew.h>
+
+#include <cstddef>
+
+#include "Camera.h"
+#include "Math.h"
+
+namespace bdEngine {
+
+/*!
+ * Per-frame shader constants, laid out like the std140 uniform block
+ * declared by FrameUniforms::glslBlock (the vec2 is aligned to 8 bytes,
+ * hence the padding after time).
+ */
+struct FrameData {
+	Mat4 view;
+	Mat4 projection;
+	Mat4 viewProjection;
+	float time;
+	float padding;
+	float viewportSize[2];
+};
+
+static_assert(offsetof(FrameData, time) == 192, "FrameData does not match the std140 layout.");
+static_assert(offsetof(FrameData, viewportSize) == 200, "FrameData does not match the std140 layout.");
+
+/*!
+ * Uniform buffer holding the FrameData of the current frame.
+ *
+ * The buffer is bound to a fixed binding point once; every shader program
+ * that declares the FrameData block links its block to that binding point
+ * (see GLShaderProgram::bindUniformBlock()) and sees the same data without
+ * any glUniform calls of its own.
+ */
+class FrameUniforms {
+public:
+	/*! Name of the uniform block in GLSL. */
+	static const GLchar* const blockName;
+	
+	/*!
+	 * Version directive and declaration of the uniform block in GLSL.
+	 * Shaders using the block put it in front of their own source code
+	 * (see GLShaderProgram::addShader()), which must not repeat #version.
+	 */
+	static const GLchar* const glslBlock;
+	
+	/*! Binding point of the uniform buffer. */
+	static const GLuint bindingPoint = 0;
+	
+	
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates the uniform buffer and binds it to the binding point.
+	 */
+	FrameUniforms();
+	~FrameUniforms();
+	
+	// --- Forbid copy and move operations
+	FrameUniforms(const FrameUniforms& other)            = delete;  // copy constructor
+	FrameUniforms& operator=(const FrameUniforms& other) = delete;  // copy assignment
+	FrameUniforms(FrameUniforms&& other)                 = delete;  // move constructor
+	FrameUniforms& operator=(FrameUniforms&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Updating
+	 *******************************************************************/
+	/*!
+	 * Uploads the matrices of the camera and the time in seconds. Has to
+	 * be called once per frame before drawing.
+	 */
+	void update(const Camera& camera, float time);
+	
+	/*!
+	 * Returns the data uploaded last.
+	 */
+	const FrameData& getData() const {
+		return data_;
+	}
+
+private:
+	// Internal buffer ID
+	GLuint bufferID_ = 0;
+	
+	// CPU copy of the buffer contents
+	FrameData data_;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_FRAMEUNIFORMS_H */
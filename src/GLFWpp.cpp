@@ -122,31 +122,61 @@ Window::~Window() {
 // Window copy constructor/assignment: deleted
 
 // Window move constructor
-Window::Window(Window&& other) {
-	// Copy data from other object
-	win_ = other.win_;
-	
-	// Reset other object to default state - it now shouldn't be used anymore!
-	other.win_ = nullptr;
+Window::Window(Window&& other)
+	: win_ {nullptr}
+{
+	moveFrom(other);
 }
 
 // Window move assignment
 Window& Window::operator=(Window&& other) {
 	if (this != &other) {
-		// Clean up old data from this object (see ~Window())
+		// Clean up old data from this object (see ~Window()), unlinking it
+		// first so no callback reaches this object while it is destroyed
 		if (win_ != nullptr) {
+			glfwSetWindowUserPointer(win_, nullptr);
 			glfwDestroyWindow(win_);
 		}
 		
-		// Copy data from other object
-		win_ = other.win_;
-		
-		// Reset other object to default state - it now shouldn't be used anymore!
-		other.win_ = nullptr;
+		moveFrom(other);
 	}
 	return *this;
 }
 
+// Helper for the move operations
+void Window::moveFrom(Window& other) {
+	// Take data from other object (the callback trampolines call the
+	// functions of the object the user pointer points to)
+	win_ = other.win_;
+	listener_ = other.listener_;
+	
+	windowPosCallbackFun = std::move(other.windowPosCallbackFun);
+	windowSizeCallbackFun = std::move(other.windowSizeCallbackFun);
+	windowCloseCallbackFun = std::move(other.windowCloseCallbackFun);
+	windowRefreshCallbackFun = std::move(other.windowRefreshCallbackFun);
+	windowFocusCallbackFun = std::move(other.windowFocusCallbackFun);
+	windowIconifyCallbackFun = std::move(other.windowIconifyCallbackFun);
+	framebufferSizeCallbackFun = std::move(other.framebufferSizeCallbackFun);
+	
+	keyCallbackFun = std::move(other.keyCallbackFun);
+	charCallbackFun = std::move(other.charCallbackFun);
+	charModsCallbackFun = std::move(other.charModsCallbackFun);
+	mouseButtonCallbackFun = std::move(other.mouseButtonCallbackFun);
+	cursorPosCallbackFun = std::move(other.cursorPosCallbackFun);
+	cursorEnterCallbackFun = std::move(other.cursorEnterCallbackFun);
+	scrollCallbackFun = std::move(other.scrollCallbackFun);
+	dropCallbackFun = std::move(other.dropCallbackFun);
+	
+	// Reset other object to default state - it now shouldn't be used anymore!
+	other.win_ = nullptr;
+	other.listener_ = nullptr;
+	
+	// Link the window to this object (for the callbacks)
+	if (win_ != nullptr) {
+		glfwSetWindowUserPointer(win_, this);
+	}
+}
+
 /*! @brief Returns the monitor that the window uses for full screen mode. */
 std::unique_ptr<Monitor> Window::getMonitor() {
 	GLFWmonitor* monitorPtr = glfwGetWindowMonitor(win_);
@@ -470,6 +500,63 @@ void Window::setDropCallback(dropCallbackFun_t cbFun) {
 	}
 }
 
+// -- Static event listener
+
+/*! @brief Removes the listener set by setListener(). */
+void Window::unsetListener() {
+	if (listener_ == nullptr) {
+		return;
+	}
+	listener_ = nullptr;
+	
+	// Events without callback function have no callback or the listener's
+	if (!windowPosCallbackFun) {
+		glfwSetWindowPosCallback(win_, nullptr);
+	}
+	if (!windowSizeCallbackFun) {
+		glfwSetWindowSizeCallback(win_, nullptr);
+	}
+	if (!windowCloseCallbackFun) {
+		glfwSetWindowCloseCallback(win_, nullptr);
+	}
+	if (!windowRefreshCallbackFun) {
+		glfwSetWindowRefreshCallback(win_, nullptr);
+	}
+	if (!windowFocusCallbackFun) {
+		glfwSetWindowFocusCallback(win_, nullptr);
+	}
+	if (!windowIconifyCallbackFun) {
+		glfwSetWindowIconifyCallback(win_, nullptr);
+	}
+	if (!framebufferSizeCallbackFun) {
+		glfwSetFramebufferSizeCallback(win_, nullptr);
+	}
+	if (!keyCallbackFun) {
+		glfwSetKeyCallback(win_, nullptr);
+	}
+	if (!charCallbackFun) {
+		glfwSetCharCallback(win_, nullptr);
+	}
+	if (!charModsCallbackFun) {
+		glfwSetCharModsCallback(win_, nullptr);
+	}
+	if (!mouseButtonCallbackFun) {
+		glfwSetMouseButtonCallback(win_, nullptr);
+	}
+	if (!cursorPosCallbackFun) {
+		glfwSetCursorPosCallback(win_, nullptr);
+	}
+	if (!cursorEnterCallbackFun) {
+		glfwSetCursorEnterCallback(win_, nullptr);
+	}
+	if (!scrollCallbackFun) {
+		glfwSetScrollCallback(win_, nullptr);
+	}
+	if (!dropCallbackFun) {
+		glfwSetDropCallback(win_, nullptr);
+	}
+}
+
 
 /*************************************************************************
  * Wrappers for context related functions
@@ -13,6 +13,7 @@
 #include <memory>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace GLFW {
@@ -1099,6 +1100,12 @@ private:
 	scrollCallbackFun_t scrollCallbackFun;
 	dropCallbackFun_t dropCallbackFun;
 	
+	/*! Listener object set by setListener() (or nullptr). */
+	void* listener_ = nullptr;
+	
+	/*! Takes over the window, callbacks and listener of other (for the move operations). */
+	void moveFrom(Window& other);
+	
 public:
 	/*********************************************************************
 	 * Wrappers for window related functions
@@ -2385,9 +2392,243 @@ public:
 	void unsetDropCallback() {
 		setDropCallback(nullptr);
 	}
+	
+	
+	/*********************************************************************
+	 * Static event listener
+	 *********************************************************************/
+	
+	/*! @brief Sets a listener object that receives the events of the window.
+	 *
+	 *  This is the compile time alternative to the callback setters: for every
+	 *  event the `Listener` type has a method for, a callback is installed that
+	 *  calls that method directly, without `std::function` and without any
+	 *  allocation, so the call can be inlined.  Events without a method are
+	 *  left alone.  This matters for high rate events like cursor movement.
+	 *
+	 *  The methods take the same arguments as the callbacks (see the callback
+	 *  function signatures) and are all optional: `onWindowPos`,
+	 *  `onWindowSize`, `onWindowClose`, `onWindowRefresh`, `onWindowFocus`,
+	 *  `onWindowIconify`, `onFramebufferSize`, `onKey`, `onChar`,
+	 *  `onCharMods`, `onMouseButton`, `onCursorPos`, `onCursorEnter`,
+	 *  `onScroll` and `onDrop`.
+	 *
+	 *  The listener replaces the previous listener and the callbacks of the
+	 *  events it handles.  Setting a callback afterwards replaces the listener
+	 *  for that event.  The listener must outlive the window (or be unset).
+	 *
+	 *  @param[in] listener The object to call.
+	 *
+	 *  @thread_safety This function must only be called from the main thread.
+	 */
+	template <class Listener>
+	void setListener(Listener& listener);
+	
+	/*! @brief Removes the listener set by setListener().
+	 *
+	 *  Callbacks set with the callback setters are kept.
+	 *
+	 *  @thread_safety This function must only be called from the main thread.
+	 */
+	void unsetListener();
+
+private:
+	// -- Listener binding: installs a callback calling the listener method if
+	// it exists (int overload), does nothing otherwise (long overload)
+	
+	template <class Listener>
+	auto bindWindowPosListener(int) -> decltype(std::declval<Listener&>().onWindowPos(std::declval<Window&>(), 0, 0), void()) {
+		windowPosCallbackFun = nullptr;
+		glfwSetWindowPosCallback(win_, [](GLFWwindow* win, int xpos, int ypos) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onWindowPos(*window, xpos, ypos);
+		});
+	}
+	template <class Listener>
+	void bindWindowPosListener(long) {}
+	
+	template <class Listener>
+	auto bindWindowSizeListener(int) -> decltype(std::declval<Listener&>().onWindowSize(std::declval<Window&>(), 0, 0), void()) {
+		windowSizeCallbackFun = nullptr;
+		glfwSetWindowSizeCallback(win_, [](GLFWwindow* win, int width, int height) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onWindowSize(*window, width, height);
+		});
+	}
+	template <class Listener>
+	void bindWindowSizeListener(long) {}
+	
+	template <class Listener>
+	auto bindWindowCloseListener(int) -> decltype(std::declval<Listener&>().onWindowClose(std::declval<Window&>()), void()) {
+		windowCloseCallbackFun = nullptr;
+		glfwSetWindowCloseCallback(win_, [](GLFWwindow* win) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onWindowClose(*window);
+		});
+	}
+	template <class Listener>
+	void bindWindowCloseListener(long) {}
+	
+	template <class Listener>
+	auto bindWindowRefreshListener(int) -> decltype(std::declval<Listener&>().onWindowRefresh(std::declval<Window&>()), void()) {
+		windowRefreshCallbackFun = nullptr;
+		glfwSetWindowRefreshCallback(win_, [](GLFWwindow* win) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onWindowRefresh(*window);
+		});
+	}
+	template <class Listener>
+	void bindWindowRefreshListener(long) {}
+	
+	template <class Listener>
+	auto bindWindowFocusListener(int) -> decltype(std::declval<Listener&>().onWindowFocus(std::declval<Window&>(), false), void()) {
+		windowFocusCallbackFun = nullptr;
+		glfwSetWindowFocusCallback(win_, [](GLFWwindow* win, int focused) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onWindowFocus(*window, (focused == GLFW_TRUE));
+		});
+	}
+	template <class Listener>
+	void bindWindowFocusListener(long) {}
+	
+	template <class Listener>
+	auto bindWindowIconifyListener(int) -> decltype(std::declval<Listener&>().onWindowIconify(std::declval<Window&>(), false), void()) {
+		windowIconifyCallbackFun = nullptr;
+		glfwSetWindowIconifyCallback(win_, [](GLFWwindow* win, int iconified) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onWindowIconify(*window, (iconified == GLFW_TRUE));
+		});
+	}
+	template <class Listener>
+	void bindWindowIconifyListener(long) {}
+	
+	template <class Listener>
+	auto bindFramebufferSizeListener(int) -> decltype(std::declval<Listener&>().onFramebufferSize(std::declval<Window&>(), 0, 0), void()) {
+		framebufferSizeCallbackFun = nullptr;
+		glfwSetFramebufferSizeCallback(win_, [](GLFWwindow* win, int width, int height) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onFramebufferSize(*window, width, height);
+		});
+	}
+	template <class Listener>
+	void bindFramebufferSizeListener(long) {}
+	
+	template <class Listener>
+	auto bindKeyListener(int) -> decltype(std::declval<Listener&>().onKey(std::declval<Window&>(), KeyCode(), 0, InputAction(), KeyModifier()), void()) {
+		keyCallbackFun = nullptr;
+		glfwSetKeyCallback(win_, [](GLFWwindow* win, int key, int scancode, int action, int mods) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onKey(*window, static_cast<KeyCode>(key), scancode,
+				static_cast<InputAction>(action), static_cast<KeyModifier>(mods));
+		});
+	}
+	template <class Listener>
+	void bindKeyListener(long) {}
+	
+	template <class Listener>
+	auto bindCharListener(int) -> decltype(std::declval<Listener&>().onChar(std::declval<Window&>(), 0u), void()) {
+		charCallbackFun = nullptr;
+		glfwSetCharCallback(win_, [](GLFWwindow* win, unsigned int codepoint) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onChar(*window, codepoint);
+		});
+	}
+	template <class Listener>
+	void bindCharListener(long) {}
+	
+	template <class Listener>
+	auto bindCharModsListener(int) -> decltype(std::declval<Listener&>().onCharMods(std::declval<Window&>(), 0u, KeyModifier()), void()) {
+		charModsCallbackFun = nullptr;
+		glfwSetCharModsCallback(win_, [](GLFWwindow* win, unsigned int codepoint, int mods) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onCharMods(*window, codepoint, static_cast<KeyModifier>(mods));
+		});
+	}
+	template <class Listener>
+	void bindCharModsListener(long) {}
+	
+	template <class Listener>
+	auto bindMouseButtonListener(int) -> decltype(std::declval<Listener&>().onMouseButton(std::declval<Window&>(), MouseButton(), InputAction(), KeyModifier()), void()) {
+		mouseButtonCallbackFun = nullptr;
+		glfwSetMouseButtonCallback(win_, [](GLFWwindow* win, int button, int action, int mods) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onMouseButton(*window, static_cast<MouseButton>(button),
+				static_cast<InputAction>(action), static_cast<KeyModifier>(mods));
+		});
+	}
+	template <class Listener>
+	void bindMouseButtonListener(long) {}
+	
+	template <class Listener>
+	auto bindCursorPosListener(int) -> decltype(std::declval<Listener&>().onCursorPos(std::declval<Window&>(), 0.0, 0.0), void()) {
+		cursorPosCallbackFun = nullptr;
+		glfwSetCursorPosCallback(win_, [](GLFWwindow* win, double xpos, double ypos) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onCursorPos(*window, xpos, ypos);
+		});
+	}
+	template <class Listener>
+	void bindCursorPosListener(long) {}
+	
+	template <class Listener>
+	auto bindCursorEnterListener(int) -> decltype(std::declval<Listener&>().onCursorEnter(std::declval<Window&>(), false), void()) {
+		cursorEnterCallbackFun = nullptr;
+		glfwSetCursorEnterCallback(win_, [](GLFWwindow* win, int entered) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onCursorEnter(*window, (entered == GLFW_TRUE));
+		});
+	}
+	template <class Listener>
+	void bindCursorEnterListener(long) {}
+	
+	template <class Listener>
+	auto bindScrollListener(int) -> decltype(std::declval<Listener&>().onScroll(std::declval<Window&>(), 0.0, 0.0), void()) {
+		scrollCallbackFun = nullptr;
+		glfwSetScrollCallback(win_, [](GLFWwindow* win, double xoffset, double yoffset) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onScroll(*window, xoffset, yoffset);
+		});
+	}
+	template <class Listener>
+	void bindScrollListener(long) {}
+	
+	template <class Listener>
+	auto bindDropListener(int) -> decltype(std::declval<Listener&>().onDrop(std::declval<Window&>(), std::vector<std::string>()), void()) {
+		dropCallbackFun = nullptr;
+		glfwSetDropCallback(win_, [](GLFWwindow* win, int count, const char** paths) {
+			Window* window = static_cast<Window*>(glfwGetWindowUserPointer(win));
+			static_cast<Listener*>(window->listener_)->onDrop(*window, std::vector<std::string>(paths, paths + count));
+		});
+	}
+	template <class Listener>
+	void bindDropListener(long) {}
 };
 
 
+/*! @brief Sets a listener object that receives the events of the window. */
+template <class Listener>
+void Window::setListener(Listener& listener) {
+	unsetListener();
+	listener_ = &listener;
+	
+	bindWindowPosListener<Listener>(0);
+	bindWindowSizeListener<Listener>(0);
+	bindWindowCloseListener<Listener>(0);
+	bindWindowRefreshListener<Listener>(0);
+	bindWindowFocusListener<Listener>(0);
+	bindWindowIconifyListener<Listener>(0);
+	bindFramebufferSizeListener<Listener>(0);
+	bindKeyListener<Listener>(0);
+	bindCharListener<Listener>(0);
+	bindCharModsListener<Listener>(0);
+	bindMouseButtonListener<Listener>(0);
+	bindCursorPosListener<Listener>(0);
+	bindCursorEnterListener<Listener>(0);
+	bindScrollListener<Listener>(0);
+	bindDropListener<Listener>(0);
+}
+
+
 /*! @brief Resets all window hints to their default values.
  *
  *  This function resets all window hints to their
@@ -1,10 +1,15 @@
 #include "GLShaderProgram.h"
+#include "RenderStats.h"
 
 // TODO implement own logging class
 #include <iostream>
 
 namespace bdEngine {
 
+// Program made current by the last useProgram() (switches to the same
+// program are skipped)
+static GLuint currentProgramID = 0;
+
 /*******************************************************************
  * Construction and destruction
  *******************************************************************/
@@ -25,6 +30,9 @@ GLShaderProgram::~GLShaderProgram() {
 	// Free program object
 	if (programID) {
 		glDeleteProgram(programID);
+		if (currentProgramID == programID) {
+			currentProgramID = 0;
+		}
 	}
 }
 
@@ -33,7 +41,7 @@ GLShaderProgram::~GLShaderProgram() {
  * Compiling and linking
  *******************************************************************/
 
-bool GLShaderProgram::addShader(const GLchar * const * ppcSrc, GLenum shaderType) {
+bool GLShaderProgram::addShader(const GLchar * const * ppcSrc, GLenum shaderType, GLsizei count) {
 	// Create shader object
 	GLuint shaderID = glCreateShader(shaderType);
 	
@@ -46,7 +54,7 @@ bool GLShaderProgram::addShader(const GLchar * const * ppcSrc, GLenum shaderType
 	vecShaderIDs.push_back(shaderID);
 	
 	// Compile shader
-	glShaderSource(shaderID, 1, ppcSrc, nullptr);
+	glShaderSource(shaderID, count, ppcSrc, nullptr);
 	glCompileShader(shaderID);
 	
 	// Check for compile errors
@@ -76,6 +84,13 @@ bool GLShaderProgram::addShader(const GLchar * const * ppcSrc, GLenum shaderType
 	return true;
 }
 
+void GLShaderProgram::setTransformFeedbackVaryings(const GLchar* const* varyings, GLsizei count,
+	GLenum bufferMode)
+{
+	// Takes effect on the next link
+	glTransformFeedbackVaryings(programID, count, varyings, bufferMode);
+}
+
 bool GLShaderProgram::linkShaders() {
 	// Link shaders to program
 	glLinkProgram(programID);
@@ -106,7 +121,12 @@ bool GLShaderProgram::linkShaders() {
 
 void GLShaderProgram::useProgram() {
 	// Make shader program current
+	if (programID == currentProgramID) {
+		return;
+	}
 	glUseProgram(programID);
+	currentProgramID = programID;
+	countProgramSwitch();
 }
 
 
@@ -122,5 +142,15 @@ GLint GLShaderProgram::getUniformLocation(const GLchar* name) {
 	return glGetUniformLocation(programID, name);
 }
 
+bool GLShaderProgram::bindUniformBlock(const GLchar* name, GLuint bindingPoint) {
+	GLuint blockIndex = glGetUniformBlockIndex(programID, name);
+	if (blockIndex == GL_INVALID_INDEX) {
+		return false;
+	}
+	
+	glUniformBlockBinding(programID, blockIndex, bindingPoint);
+	return true;
+}
+
 
 } // end namespace bdEngine
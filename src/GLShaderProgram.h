@@ -34,10 +34,18 @@ public:
 	}
 	
 	/*!
-	 * Adds a shader of a certain type and compiles it.
+	 * Adds a shader of a certain type and compiles it. ppcSrc points to
+	 * count strings, which are concatenated to the source code.
 	 * Prints error message and returns false if compilation fails.
 	 */
-	bool addShader(const GLchar * const * ppcSrc, GLenum shaderType);
+	bool addShader(const GLchar * const * ppcSrc, GLenum shaderType, GLsizei count = 1);
+	
+	/*!
+	 * Selects vertex shader outputs to be captured by transform feedback.
+	 * Has to be called before linkShaders().
+	 */
+	void setTransformFeedbackVaryings(const GLchar* const* varyings, GLsizei count,
+		GLenum bufferMode = GL_INTERLEAVED_ATTRIBS);
 	
 	/*!
 	 * Links all shaders to the program.
@@ -46,7 +54,7 @@ public:
 	bool linkShaders();
 	
 	/*!
-	 * Makes this program current.
+	 * Makes this program current (does nothing if it already is).
 	 */
 	void useProgram();
 	
@@ -65,6 +73,12 @@ public:
 	 */
 	GLint getUniformLocation(const GLchar* name);
 	
+	/*!
+	 * Links a named uniform block to a uniform buffer binding point.
+	 * Returns false if the program has no such block.
+	 */
+	bool bindUniformBlock(const GLchar* name, GLuint bindingPoint);
+	
 protected:
 	// Internal program ID
 	GLuint programID = 0;
@@ -0,0 +1,283 @@
+#include "GPUParticleSystem.h"
+#include "FrameUniforms.h"
+#include "RenderStats.h"
+
+#include <algorithm>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Constants, shader sources
+ *******************************************************************/
+
+// Vertex shader source code for the simulation step
+static const GLchar* updateVertexShaderSrc = R"__SRC__(
+#version 330 core
+
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 velocity;
+layout (location = 2) in float life;
+layout (location = 3) in float size;
+layout (location = 4) in uint color;
+
+out vec2 outPosition;
+out vec2 outVelocity;
+out float outLife;
+out float outSize;
+flat out uint outColor;
+
+uniform float dt;
+uniform vec2 gravity;
+
+void main() {
+	// Semi-implicit Euler, dead particles stay where they are
+	vec2 v = velocity;
+	vec2 p = position;
+	if (life > 0.0) {
+		v += gravity * dt;
+		p += v * dt;
+	}
+	
+	outPosition = p;
+	outVelocity = v;
+	outLife = life - dt;
+	outSize = size;
+	outColor = color;
+}
+
+)__SRC__";
+
+// Vertex shader source code for drawing (after FrameUniforms::glslBlock)
+static const GLchar* drawVertexShaderSrc = R"__SRC__(
+
+layout (location = 0) in vec2 corner;
+layout (location = 1) in vec2 position;
+layout (location = 2) in float life;
+layout (location = 3) in float size;
+layout (location = 4) in vec4 color;
+
+out vec2 fragCoord;
+out vec4 fragColor;
+
+uniform float fadeOutTime;
+
+void main() {
+	// Collapse dead particles, so that they are not rasterized
+	float alive = life > 0.0 ? 1.0 : 0.0;
+	gl_Position = viewProjection * vec4(position + corner * size * alive, 0.0, 1.0);
+	fragCoord = corner * 2.0;
+	fragColor = vec4(color.rgb, color.a * clamp(life / fadeOutTime, 0.0, 1.0));
+}
+
+)__SRC__";
+
+// Outputs of the simulation step, in the order of the Particle members
+static const GLchar* const updateVaryings[] = {
+	"outPosition",
+	"outVelocity",
+	"outLife",
+	"outSize",
+	"outColor",
+};
+
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+GPUParticleSystem::GPUParticleSystem(std::size_t maxParticles)
+	: ParticleSystem(maxParticles)
+{
+	spawned_.reserve(maxParticles);
+	
+	// -- Compile and link shader programs
+	updateProgram_.addShader(&updateVertexShaderSrc, GL_VERTEX_SHADER);
+	updateProgram_.setTransformFeedbackVaryings(updateVaryings, 5);
+	updateProgram_.linkShaders();
+	
+	const GLchar* vertexShaderSrcs[] = {FrameUniforms::glslBlock, drawVertexShaderSrc};
+	drawProgram_.addShader(vertexShaderSrcs, GL_VERTEX_SHADER, 2);
+	drawProgram_.addShader(&fragShaderSrc, GL_FRAGMENT_SHADER);
+	drawProgram_.linkShaders();
+	drawProgram_.bindUniformBlock(FrameUniforms::blockName, FrameUniforms::bindingPoint);
+	
+	glGenBuffers(1, &quadVBO_);
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO_);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quadCorners), quadCorners, GL_STATIC_DRAW);
+	
+	glGenBuffers(2, particleVBOs_);
+	glGenVertexArrays(2, updateVAOs_);
+	glGenVertexArrays(2, drawVAOs_);
+	
+	const GLsizei stride = sizeof(Particle);
+	for (int i = 0; i < 2; ++i) {
+		glBindBuffer(GL_ARRAY_BUFFER, particleVBOs_[i]);
+		glBufferData(GL_ARRAY_BUFFER, maxParticles * sizeof(Particle), nullptr, GL_DYNAMIC_COPY);
+		
+		// Simulation step reads all particle attributes per vertex
+		glBindVertexArray(updateVAOs_[i]);
+		// -> location 0: position
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)offsetof(Particle, x));
+		glEnableVertexAttribArray(0);
+		// -> location 1: velocity
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)offsetof(Particle, velocityX));
+		glEnableVertexAttribArray(1);
+		// -> location 2: life
+		glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride, (GLvoid*)offsetof(Particle, life));
+		glEnableVertexAttribArray(2);
+		// -> location 3: size
+		glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (GLvoid*)offsetof(Particle, size));
+		glEnableVertexAttribArray(3);
+		// -> location 4: color (as integer, passed through)
+		glVertexAttribIPointer(4, 1, GL_UNSIGNED_INT, stride, (GLvoid*)offsetof(Particle, color));
+		glEnableVertexAttribArray(4);
+		
+		// Drawing reads the quad corners per vertex, particles per instance
+		glBindVertexArray(drawVAOs_[i]);
+		glBindBuffer(GL_ARRAY_BUFFER, quadVBO_);
+		// -> location 0: corner
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid*)0);
+		glEnableVertexAttribArray(0);
+		
+		glBindBuffer(GL_ARRAY_BUFFER, particleVBOs_[i]);
+		// -> location 1: position
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*)offsetof(Particle, x));
+		glEnableVertexAttribArray(1);
+		glVertexAttribDivisor(1, 1);
+		// -> location 2: life
+		glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride, (GLvoid*)offsetof(Particle, life));
+		glEnableVertexAttribArray(2);
+		glVertexAttribDivisor(2, 1);
+		// -> location 3: size
+		glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (GLvoid*)offsetof(Particle, size));
+		glEnableVertexAttribArray(3);
+		glVertexAttribDivisor(3, 1);
+		// -> location 4: color (as normalized bytes)
+		glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (GLvoid*)offsetof(Particle, color));
+		glEnableVertexAttribArray(4);
+		glVertexAttribDivisor(4, 1);
+	}
+	
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	
+	bufferBytes_ = sizeof(quadCorners) + 2 * maxParticles * sizeof(Particle);
+	trackAllocation(MemoryTag::BufferGPU, bufferBytes_);
+}
+
+// Destructor
+GPUParticleSystem::~GPUParticleSystem() {
+	glDeleteVertexArrays(2, updateVAOs_);
+	glDeleteVertexArrays(2, drawVAOs_);
+	glDeleteBuffers(2, particleVBOs_);
+	glDeleteBuffers(1, &quadVBO_);
+	trackDeallocation(MemoryTag::BufferGPU, bufferBytes_);
+}
+
+
+/*******************************************************************
+ * Simulation
+ *******************************************************************/
+
+bool GPUParticleSystem::spawn(const ParticleSpawn& particle) {
+	if (spawned_.size() == maxParticles_) {
+		return false;
+	}
+	
+	spawned_.push_back(Particle {
+		particle.position.x, particle.position.y,
+		particle.velocity.x, particle.velocity.y,
+		particle.life, particle.size, particle.color
+	});
+	maxLife_ = std::max(maxLife_, particle.life);
+	return true;
+}
+
+void GPUParticleSystem::update(float dt) {
+	uploadSpawned();
+	
+	// Start over once every particle in the ring is dead
+	maxLife_ -= dt;
+	if (maxLife_ <= 0.0f) {
+		clear();
+		return;
+	}
+	
+	// -- Integrate from the current buffer into the other one
+	int target = 1 - current_;
+	
+	updateProgram_.useProgram();
+	glUniform1f(updateProgram_.getUniformLocation("dt"), dt);
+	glUniform2f(updateProgram_.getUniformLocation("gravity"), gravity_.x, gravity_.y);
+	countUniformUpload(2);
+	
+	glEnable(GL_RASTERIZER_DISCARD);
+	glBindVertexArray(updateVAOs_[current_]);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, particleVBOs_[target]);
+	
+	glBeginTransformFeedback(GL_POINTS);
+	glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(active_));
+	glEndTransformFeedback();
+	countDrawCall(0);
+	
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+	glBindVertexArray(0);
+	glDisable(GL_RASTERIZER_DISCARD);
+	
+	current_ = target;
+}
+
+void GPUParticleSystem::clear() {
+	spawned_.clear();
+	active_ = 0;
+	next_ = 0;
+	maxLife_ = 0.0f;
+}
+
+
+/*******************************************************************
+ * Drawing
+ *******************************************************************/
+
+void GPUParticleSystem::draw() {
+	if (active_ == 0) {
+		return;
+	}
+	
+	drawProgram_.useProgram();
+	glUniform1f(drawProgram_.getUniformLocation("fadeOutTime"), fadeOutTime);
+	glBindVertexArray(drawVAOs_[current_]);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(active_));
+	countUniformUpload();
+	countDrawCall(active_ * 2);
+	glBindVertexArray(0);
+}
+
+
+/*******************************************************************
+ * Internal helpers
+ *******************************************************************/
+
+void GPUParticleSystem::uploadSpawned() {
+	if (spawned_.empty()) {
+		return;
+	}
+	
+	// Write at the ring position, wrapping around at the end of the buffer
+	glBindBuffer(GL_ARRAY_BUFFER, particleVBOs_[current_]);
+	std::size_t count = spawned_.size();
+	std::size_t first = std::min(count, maxParticles_ - next_);
+	glBufferSubData(GL_ARRAY_BUFFER, next_ * sizeof(Particle), first * sizeof(Particle), spawned_.data());
+	if (first < count) {
+		glBufferSubData(GL_ARRAY_BUFFER, 0, (count - first) * sizeof(Particle), spawned_.data() + first);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	countUpload(count, count * sizeof(Particle));
+	
+	next_ = (next_ + count) % maxParticles_;
+	active_ = std::min(active_ + count, maxParticles_);
+	spawned_.clear();
+}
+
+} // end namespace bdEngine
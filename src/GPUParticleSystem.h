@@ -0,0 +1,104 @@
+#ifndef _BDENGINE_GPUPARTICLESYSTEM_H
+#define _BDENGINE_GPUPARTICLESYSTEM_H
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GLShaderProgram.h"
+#include "MemoryStats.h"
+#include "ParticleSystem.h"
+
+namespace bdEngine {
+
+/*!
+ * 2D particles simulated on the GPU with transform feedback.
+ *
+ * Particles live in two vertex buffers used in turns: update() runs a
+ * vertex shader over the current buffer and captures the integrated
+ * particles into the other one, with rasterization disabled. The CPU only
+ * uploads newly spawned particles, so its cost does not depend on the
+ * number of particles.
+ *
+ * Without reading back from the GPU, dead particles can't be compacted.
+ * Instead, spawned particles are written into the buffers as a ring, and
+ * dead ones are skipped by the shaders. When the ring is full, the oldest
+ * particles are replaced. Once the longest living particle is known to be
+ * dead, the ring starts over from the beginning.
+ */
+class GPUParticleSystem final : public ParticleSystem {
+public:
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates an empty system for up to maxParticles particles.
+	 */
+	explicit GPUParticleSystem(std::size_t maxParticles = 100000);
+	~GPUParticleSystem();
+	
+	
+	/*******************************************************************
+	 * ParticleSystem
+	 *******************************************************************/
+	/*!
+	 * Queues a particle for the next update(). Returns false if
+	 * maxParticles particles are queued already.
+	 */
+	bool spawn(const ParticleSpawn& particle) override;
+	void update(float dt) override;
+	void clear() override;
+	void draw() override;
+	
+	/*!
+	 * Returns the number of particles in the ring, some of which may have
+	 * died since.
+	 */
+	std::size_t size() const override {
+		return active_;
+	}
+
+private:
+	// Particle as stored in the vertex buffers (the layout of the
+	// transform feedback varyings)
+	struct Particle {
+		float x, y;
+		float velocityX, velocityY;
+		float life;
+		float size;
+		std::uint32_t color;
+	};
+	
+	// Copies the queued particles into the current buffer
+	void uploadSpawned();
+	
+	// Particles spawned since the last update()
+	std::vector<Particle, TrackingAllocator<Particle, MemoryTag::Particles>> spawned_;
+	
+	// Ring of particles in the buffers
+	std::size_t active_ = 0;
+	std::size_t next_ = 0;
+	
+	// Remaining life of the longest living particle
+	float maxLife_ = 0.0f;
+	
+	// Shader programs
+	GLShaderProgram updateProgram_;
+	GLShaderProgram drawProgram_;
+	
+	// GL objects, two of each for the ping-pong buffers
+	GLuint particleVBOs_[2] = {0, 0};
+	GLuint updateVAOs_[2] = {0, 0};
+	GLuint drawVAOs_[2] = {0, 0};
+	GLuint quadVBO_ = 0;
+	std::size_t bufferBytes_ = 0;
+	
+	// Index of the buffer with the current particles
+	int current_ = 0;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_GPUPARTICLESYSTEM_H */
@@ -1,41 +1,64 @@
 #include "Image.h"
 
+#include <limits>
 #include <stdexcept>
+#include <string>
 #include <SOIL/SOIL.h>
 
+#include "MappedFile.h"
+#include "MemoryStats.h"
+#include "QOI.h"
+
 namespace bdEngine {
 
 /*******************************************************************
  * Construction and destruction
  *******************************************************************/
 
-// Constructor
-Image::Image(const char* filename) {
-	// Load image data, retrieve width and height
-	imageData = SOIL_load_image(filename, &width, &height, 0, SOIL_LOAD_RGB);
+// Constructor (blank image)
+Image::Image(int width, int height, int channels, ImageAllocator& allocator)
+	: width {width}
+	, height {height}
+	, channels {channels}
+{
+	dataSize = std::size_t(width) * height * channels;
+	imageData = static_cast<unsigned char*>(allocator.allocate(dataSize));
+	this->allocator = &allocator;
+}
+
+// Constructor (file)
+Image::Image(const char* filename, ImageAllocator& allocator) {
+	// Map file into memory instead of reading it into a buffer
+	MappedFile file {filename};
 	
-	// Check for errors
-	if (imageData == nullptr) {
+	try {
+		decode(file.getData(), file.getSize(), allocator);
+	}
+	catch (std::runtime_error& e) {
 		// TODO Custom exception types
-		throw std::runtime_error( "SOIL loading error for file '" + std::string(filename) + "': "
-			+ std::string(SOIL_last_result()) );
+		throw std::runtime_error("Error loading image file '" + std::string(filename) + "': " + e.what());
 	}
 }
 
+// Constructor (memory)
+Image::Image(const unsigned char* data, std::size_t size, ImageAllocator& allocator) {
+	decode(data, size, allocator);
+}
+
 // Destructor
 Image::~Image() {
-	if (imageData != nullptr) {
-		// Free image resources
-		SOIL_free_image_data(imageData);
-	}
+	release();
 }
 
 // Move constructor
 Image::Image(Image&& other) {
 	// Copy image data and other attributes from other object
 	imageData = other.imageData;
+	allocator = other.allocator;
+	dataSize = other.dataSize;
 	width = other.width;
 	height = other.height;
+	channels = other.channels;
 	
 	// Reset other object so that the destructor doesn't destroy the (moved) image data.
 	other.imageData = nullptr;
@@ -45,12 +68,15 @@ Image::Image(Image&& other) {
 Image& Image::operator=(Image&& other) {
 	if (this != &other) {
 		// First, destroy the current object by freeing image resources.
-		SOIL_free_image_data(imageData);
+		release();
 		
 		// Now, copy data from source object.
 		imageData = other.imageData;
+		allocator = other.allocator;
+		dataSize = other.dataSize;
 		width = other.width;
 		height = other.height;
+		channels = other.channels;
 		
 		// Reset other object so that the destructor doesn't destroy the (moved) image data.
 		other.imageData = nullptr;
@@ -60,4 +86,62 @@ Image& Image::operator=(Image&& other) {
 }
 
 
+/*******************************************************************
+ * Decoding
+ *******************************************************************/
+
+void Image::decode(const unsigned char* data, std::size_t size, ImageAllocator& allocator) {
+	if (isQOI(data, size)) {
+		// Decode QOI ourselves, straight into the pixel buffer
+		QOIHeader header = readQOIHeader(data, size);
+		dataSize = std::size_t(header.width) * header.height * header.channels;
+		imageData = static_cast<unsigned char*>(allocator.allocate(dataSize));
+		this->allocator = &allocator;
+		
+		try {
+			decodeQOI(data, size, imageData, dataSize, header.channels);
+		}
+		catch (...) {
+			release();
+			throw;
+		}
+		
+		width = header.width;
+		height = header.height;
+		channels = header.channels;
+		return;
+	}
+	
+	if (size > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+		throw std::runtime_error("Image data too large for SOIL.");
+	}
+	
+	// Load image data, retrieve width and height
+	imageData = SOIL_load_image_from_memory(data, static_cast<int>(size), &width, &height, 0, SOIL_LOAD_RGB);
+	
+	// Check for errors
+	if (imageData == nullptr) {
+		throw std::runtime_error("SOIL loading error: " + std::string(SOIL_last_result()));
+	}
+	
+	channels = 3;
+	dataSize = std::size_t(width) * height * channels;
+	trackAllocation(MemoryTag::Image, dataSize);
+}
+
+void Image::release() {
+	if (imageData != nullptr) {
+		// Free image resources
+		if (allocator == nullptr) {
+			SOIL_free_image_data(imageData);
+			trackDeallocation(MemoryTag::Image, dataSize);
+		}
+		else {
+			allocator->deallocate(imageData, dataSize);
+		}
+		imageData = nullptr;
+	}
+}
+
+
 } // end namespace bdEngine
@@ -1,6 +1,10 @@
 #ifndef _BDENGINE_IMAGE_H
 #define _BDENGINE_IMAGE_H
 
+#include <cstddef>
+
+#include "ImageAllocator.h"
+
 namespace bdEngine {
 
 class Image {
@@ -14,9 +18,27 @@ public:
 	Image() {}
 	
 	/*!
-	 * Loads image from file.
+	 * Creates an uninitialized image of the given size, with pixel storage
+	 * taken from allocator.
+	 */
+	Image(int width, int height, int channels,
+		ImageAllocator& allocator = ImageAllocator::getDefault());
+	
+	/*!
+	 * Loads image from file. The file is memory mapped and decoded like
+	 * in Image(const unsigned char*, std::size_t, ImageAllocator&).
+	 */
+	Image(const char* filename, ImageAllocator& allocator = ImageAllocator::getDefault());
+	
+	/*!
+	 * Decodes image from encoded file data in memory (e.g. a MappedFile or
+	 * a file inside an archive). QOI images are decoded by our own decoder
+	 * directly into pixel storage taken from allocator and keep their channel
+	 * count. All other formats are decoded by SOIL to RGB, which always
+	 * allocates the pixel storage itself.
 	 */
-	Image(const char* filename);
+	Image(const unsigned char* data, std::size_t size,
+		ImageAllocator& allocator = ImageAllocator::getDefault());
 	
 	/*!
 	 * Releases image resources.
@@ -57,13 +79,33 @@ public:
 		return height;
 	}
 	
+	/*!
+	 * Returns the number of color channels per pixel (3 for RGB).
+	 */
+	int getChannels() const {
+		return channels;
+	}
+	
 private:
+	// Decodes encoded image data
+	void decode(const unsigned char* data, std::size_t size, ImageAllocator& allocator);
+	
+	// Releases image data
+	void release();
+	
 	// Image pixel data
 	unsigned char* imageData = nullptr;
 	
+	// Allocator of the pixel data and its size (nullptr: allocated by SOIL)
+	ImageAllocator* allocator = nullptr;
+	std::size_t dataSize = 0;
+	
 	// Image size
 	int width = 0;
 	int height = 0;
+	
+	// Number of color channels per pixel
+	int channels = 0;
 };
 
 } // end namespace bdEngine
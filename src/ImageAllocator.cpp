@@ -0,0 +1,140 @@
+#include "ImageAllocator.h"
+#include "MemoryStats.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace bdEngine {
+
+namespace {
+
+// Smallest pooled block, smaller requests aren't worth pooling
+const std::size_t minBlockSize = 64 * 1024;
+
+} // end anonymous namespace
+
+
+/*******************************************************************
+ * ImageAllocator
+ *******************************************************************/
+
+ImageAllocator& ImageAllocator::getDefault() {
+	static HeapImageAllocator defaultAllocator;
+	return defaultAllocator;
+}
+
+
+/*******************************************************************
+ * HeapImageAllocator
+ *******************************************************************/
+
+void* HeapImageAllocator::allocate(std::size_t size) {
+	void* ptr = std::malloc(size);
+	if (ptr == nullptr) {
+		throw std::bad_alloc();
+	}
+	trackAllocation(MemoryTag::Image, size);
+	return ptr;
+}
+
+void HeapImageAllocator::deallocate(void* ptr, std::size_t size) {
+	if (ptr != nullptr) {
+		std::free(ptr);
+		trackDeallocation(MemoryTag::Image, size);
+	}
+}
+
+
+/*******************************************************************
+ * PooledImageAllocator
+ *******************************************************************/
+
+// Constructor
+PooledImageAllocator::PooledImageAllocator(std::size_t maxCachedBytes)
+	: maxCachedBytes_ {maxCachedBytes}
+{
+}
+
+// Destructor
+PooledImageAllocator::~PooledImageAllocator() {
+	trim();
+}
+
+void* PooledImageAllocator::allocate(std::size_t size) {
+	std::size_t blockSize = getBlockSize(size);
+	
+	// Reuse a cached block of the same size class if there is one
+	if (blockSize >= minBlockSize) {
+		std::lock_guard<std::mutex> lock {mutex_};
+		auto it = freeBlocks_.find(blockSize);
+		if (it != freeBlocks_.end() && !it->second.empty()) {
+			void* ptr = it->second.back();
+			it->second.pop_back();
+			cachedBytes_ -= blockSize;
+			return ptr;
+		}
+	}
+	
+	void* ptr = std::malloc(blockSize);
+	if (ptr == nullptr) {
+		throw std::bad_alloc();
+	}
+	trackAllocation(MemoryTag::Image, blockSize);
+	return ptr;
+}
+
+void PooledImageAllocator::deallocate(void* ptr, std::size_t size) {
+	if (ptr == nullptr) {
+		return;
+	}
+	
+	std::size_t blockSize = getBlockSize(size);
+	
+	// Keep block for reuse unless it is too small or the cache is full
+	if (blockSize >= minBlockSize) {
+		std::lock_guard<std::mutex> lock {mutex_};
+		if (cachedBytes_ + blockSize <= maxCachedBytes_) {
+			freeBlocks_[blockSize].push_back(ptr);
+			cachedBytes_ += blockSize;
+			return;
+		}
+	}
+	
+	std::free(ptr);
+	trackDeallocation(MemoryTag::Image, blockSize);
+}
+
+void PooledImageAllocator::trim() {
+	std::lock_guard<std::mutex> lock {mutex_};
+	
+	for (auto& sizeClass : freeBlocks_) {
+		for (void* ptr : sizeClass.second) {
+			std::free(ptr);
+			trackDeallocation(MemoryTag::Image, sizeClass.first);
+		}
+	}
+	freeBlocks_.clear();
+	cachedBytes_ = 0;
+}
+
+std::size_t PooledImageAllocator::getCachedBytes() {
+	std::lock_guard<std::mutex> lock {mutex_};
+	return cachedBytes_;
+}
+
+std::size_t PooledImageAllocator::getBlockSize(std::size_t size) {
+	if (size <= minBlockSize) {
+		return size;
+	}
+	
+	// Four size classes per power of two: round up to a multiple of a quarter
+	// of the largest power of two not greater than size (at most 25% waste).
+	std::size_t powerOfTwo = minBlockSize;
+	while (powerOfTwo <= size / 2) {
+		powerOfTwo *= 2;
+	}
+	std::size_t step = powerOfTwo / 4;
+	return (size + step - 1) / step * step;
+}
+
+} // end namespace bdEngine
@@ -0,0 +1,166 @@
+#ifndef _BDENGINE_IMAGEALLOCATOR_H
+#define _BDENGINE_IMAGEALLOCATOR_H
+
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace bdEngine {
+
+/*!
+ * Interface for allocators of image pixel storage.
+ *
+ * Pixel buffers are large (often several megabytes) and, while loading
+ * textures, short-lived. Implementations of this interface decide where they
+ * come from. Allocators used by images decoded on worker threads have to be
+ * thread-safe. The allocators below record their memory usage with the
+ * MemoryTag::Image tag (see MemoryStats.h).
+ */
+class ImageAllocator {
+public:
+	virtual ~ImageAllocator() {}
+	
+	/*!
+	 * Allocates size bytes, throws std::bad_alloc on failure.
+	 */
+	virtual void* allocate(std::size_t size) = 0;
+	
+	/*!
+	 * Releases memory returned by allocate(size).
+	 */
+	virtual void deallocate(void* ptr, std::size_t size) = 0;
+	
+	/*!
+	 * Returns the default allocator (plain malloc/free, thread-safe).
+	 */
+	static ImageAllocator& getDefault();
+};
+
+/*!
+ * Allocator that forwards to malloc and free.
+ */
+class HeapImageAllocator : public ImageAllocator {
+public:
+	void* allocate(std::size_t size) override;
+	void deallocate(void* ptr, std::size_t size) override;
+};
+
+/*!
+ * Thread-safe allocator that recycles large blocks.
+ *
+ * Requests are rounded up to size classes (four per power of two) and freed
+ * blocks are kept for reuse, up to a limit of cached bytes. Repeatedly loading
+ * and releasing images of similar size then reuses the same few blocks instead
+ * of going through malloc/free (and the kernel) for every image. Requests
+ * below 64 KiB (small mip levels, rows) are not pooled and go straight to
+ * malloc/free.
+ */
+class PooledImageAllocator : public ImageAllocator {
+public:
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates an allocator that keeps at most maxCachedBytes of freed blocks.
+	 */
+	explicit PooledImageAllocator(std::size_t maxCachedBytes = 64 * 1024 * 1024);
+	
+	/*!
+	 * Releases all cached blocks. All allocated blocks must have been
+	 * deallocated before.
+	 */
+	~PooledImageAllocator();
+	
+	// --- Forbid copy and move operations
+	PooledImageAllocator(const PooledImageAllocator& other)            = delete;  // copy constructor
+	PooledImageAllocator& operator=(const PooledImageAllocator& other) = delete;  // copy assignment
+	PooledImageAllocator(PooledImageAllocator&& other)                 = delete;  // move constructor
+	PooledImageAllocator& operator=(PooledImageAllocator&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Allocation
+	 *******************************************************************/
+	void* allocate(std::size_t size) override;
+	void deallocate(void* ptr, std::size_t size) override;
+	
+	/*!
+	 * Releases all cached blocks.
+	 */
+	void trim();
+	
+	/*!
+	 * Returns the number of bytes currently cached for reuse.
+	 */
+	std::size_t getCachedBytes();
+	
+	/*!
+	 * Returns the size class (actual block size) for a requested size, or
+	 * size itself if it is too small to be pooled.
+	 */
+	static std::size_t getBlockSize(std::size_t size);
+
+private:
+	// Free blocks by block size
+	std::unordered_map<std::size_t, std::vector<void*>> freeBlocks_;
+	std::size_t cachedBytes_ = 0;
+	std::size_t maxCachedBytes_;
+	
+	std::mutex mutex_;
+};
+
+
+/*!
+ * Standard library allocator that takes its memory from an ImageAllocator.
+ */
+template <class T>
+class ImageAllocatorAdapter {
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	
+	ImageAllocatorAdapter(ImageAllocator& imageAllocator = ImageAllocator::getDefault())
+		: imageAllocator_ {&imageAllocator}
+	{}
+	
+	template <class U>
+	ImageAllocatorAdapter(const ImageAllocatorAdapter<U>& other)
+		: imageAllocator_ {other.getImageAllocator()}
+	{}
+	
+	T* allocate(std::size_t n) {
+		return static_cast<T*>(imageAllocator_->allocate(n * sizeof(T)));
+	}
+	
+	void deallocate(T* ptr, std::size_t n) {
+		imageAllocator_->deallocate(ptr, n * sizeof(T));
+	}
+	
+	ImageAllocator* getImageAllocator() const {
+		return imageAllocator_;
+	}
+
+private:
+	ImageAllocator* imageAllocator_;
+};
+
+template <class T, class U>
+bool operator==(const ImageAllocatorAdapter<T>& a, const ImageAllocatorAdapter<U>& b) {
+	return a.getImageAllocator() == b.getImageAllocator();
+}
+
+template <class T, class U>
+bool operator!=(const ImageAllocatorAdapter<T>& a, const ImageAllocatorAdapter<U>& b) {
+	return !(a == b);
+}
+
+// Containers of pixel data
+template <class T>
+using ImageVector = std::vector<T, ImageAllocatorAdapter<T>>;
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_IMAGEALLOCATOR_H */
@@ -0,0 +1,172 @@
+#ifndef _BDENGINE_INPUTQUEUE_H
+#define _BDENGINE_INPUTQUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace bdEngine {
+
+/*!
+ * Kind of an InputEvent.
+ */
+enum class InputEventType : std::uint8_t {
+	Key,             // code: key, scancode, action, mods
+	Char,            // code: Unicode code point
+	MouseButton,     // code: button, action, mods
+	CursorPos,       // x, y: cursor position in screen coordinates
+	Scroll,          // x, y: scroll offset
+	WindowSize,      // x, y: new window size in screen coordinates (input only)
+	JoystickButton,  // code: button, action (of the polled joystick)
+	JoystickAxis,    // code: axis, x: position in [-1, 1]
+};
+
+/*!
+ * Input event as recorded by the window listener. Codes, actions and
+ * modifiers have the values of the GLFW enums.
+ */
+struct InputEvent {
+	InputEventType type;
+	std::uint8_t action;
+	std::uint16_t mods;
+	std::int32_t code;
+	std::int32_t scancode;
+	float x;
+	float y;
+	
+	// Time of the event (steady clock, nanoseconds)
+	std::uint64_t timestamp;
+	
+	/*!
+	 * Returns the current time in the unit of timestamp.
+	 */
+	static std::uint64_t now() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+};
+
+static_assert(std::is_trivially_copyable<InputEvent>::value, "InputEvent must be trivially copyable");
+
+/*!
+ * Lock-free ring buffer of input events between one producer thread (the
+ * window listener, called by GLFW::pollEvents()) and one consumer thread
+ * (the game logic).
+ *
+ * Head and tail are on separate cache lines, and each side keeps a copy of
+ * the other side's index, so that it only touches the shared index when
+ * the ring looks full (producer) or empty (consumer). Events that don't fit
+ * are dropped and counted.
+ */
+class InputQueue {
+public:
+	/*! Number of events the queue can hold (a power of two). */
+	static const std::size_t capacity = 1024;
+	
+	
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	InputQueue() {}
+	
+	// --- Forbid copy and move operations
+	InputQueue(const InputQueue& other)            = delete;  // copy constructor
+	InputQueue& operator=(const InputQueue& other) = delete;  // copy assignment
+	InputQueue(InputQueue&& other)                 = delete;  // move constructor
+	InputQueue& operator=(InputQueue&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Producer
+	 *******************************************************************/
+	/*!
+	 * Appends an event. Returns false (and drops the event) if the queue
+	 * is full.
+	 */
+	bool push(const InputEvent& event) {
+		std::size_t tail = tail_.load(std::memory_order_relaxed);
+		if (tail - cachedHead_ == capacity) {
+			cachedHead_ = head_.load(std::memory_order_acquire);
+			if (tail - cachedHead_ == capacity) {
+				dropped_.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+		}
+		
+		events_[tail & mask] = event;
+		tail_.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+	
+	
+	/*******************************************************************
+	 * Consumer
+	 *******************************************************************/
+	/*!
+	 * Takes the oldest event. Returns false if the queue is empty.
+	 */
+	bool pop(InputEvent& event) {
+		std::size_t head = head_.load(std::memory_order_relaxed);
+		if (head == cachedTail_) {
+			cachedTail_ = tail_.load(std::memory_order_acquire);
+			if (head == cachedTail_) {
+				return false;
+			}
+		}
+		
+		event = events_[head & mask];
+		head_.store(head + 1, std::memory_order_release);
+		return true;
+	}
+	
+	/*!
+	 * Calls function(const InputEvent&) for all events pushed so far, oldest
+	 * first, and removes them. Returns the number of events.
+	 */
+	template <class Function>
+	std::size_t consume(Function&& function) {
+		std::size_t head = head_.load(std::memory_order_relaxed);
+		cachedTail_ = tail_.load(std::memory_order_acquire);
+		
+		for (std::size_t i = head; i != cachedTail_; ++i) {
+			function(events_[i & mask]);
+		}
+		
+		head_.store(cachedTail_, std::memory_order_release);
+		return cachedTail_ - head;
+	}
+	
+	/*!
+	 * Returns the number of events dropped because the queue was full.
+	 */
+	std::size_t getDroppedCount() const {
+		return dropped_.load(std::memory_order_relaxed);
+	}
+
+private:
+	static const std::size_t mask = capacity - 1;
+	static const std::size_t cacheLineSize = 64;
+	static_assert((capacity & mask) == 0, "InputQueue capacity must be a power of two");
+	
+	// Ring buffer (indices grow forever and are masked on access)
+	InputEvent events_[capacity];
+	
+	// Consumer side: next event to read, copy of the producer's index
+	// (padded to a cache line of its own, without requiring over-aligned
+	// allocation)
+	char consumerPadding_[cacheLineSize];
+	std::atomic<std::size_t> head_ {0};
+	std::size_t cachedTail_ = 0;
+	
+	// Producer side: next free slot, copy of the consumer's index
+	char producerPadding_[cacheLineSize];
+	std::atomic<std::size_t> tail_ {0};
+	std::size_t cachedHead_ = 0;
+	std::atomic<std::size_t> dropped_ {0};
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_INPUTQUEUE_H */
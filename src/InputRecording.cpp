@@ -0,0 +1,145 @@
+#include "InputRecording.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace bdEngine {
+
+namespace {
+
+// Start of every recording
+const char magic[4] = {'B', 'D', 'I', 'R'};
+
+// Size of an event in the file: its fields one after the other, without
+// the padding of the struct (which is never initialized)
+const std::size_t eventSize = sizeof(InputEvent::type) + sizeof(InputEvent::action) + sizeof(InputEvent::mods)
+	+ sizeof(InputEvent::code) + sizeof(InputEvent::scancode) + sizeof(InputEvent::x) + sizeof(InputEvent::y)
+	+ sizeof(InputEvent::timestamp);
+
+// Copies a field to out and returns the position after it
+template <class T>
+unsigned char* put(unsigned char* out, const T& field) {
+	std::memcpy(out, &field, sizeof(T));
+	return out + sizeof(T);
+}
+
+// Copies a field from in and returns the position after it
+template <class T>
+const unsigned char* get(const unsigned char* in, T& field) {
+	std::memcpy(&field, in, sizeof(T));
+	return in + sizeof(T);
+}
+
+} // end anonymous namespace
+
+const std::uint32_t InputRecorder::version;
+
+
+/*******************************************************************
+ * InputRecorder
+ *******************************************************************/
+
+// Constructor
+InputRecorder::InputRecorder(const char* filename, float timestep)
+	: file_ {filename, std::ios::binary | std::ios::trunc}
+{
+	if (!file_) {
+		throw std::runtime_error("Error creating input recording '" + std::string(filename) + "'.");
+	}
+	
+	write(magic, sizeof(magic));
+	write(&version, sizeof(version));
+	write(&timestep, sizeof(timestep));
+}
+
+void InputRecorder::writeFrame(std::uint32_t ticks, const std::vector<InputEvent>& events) {
+	std::uint32_t count = static_cast<std::uint32_t>(events.size());
+	write(&ticks, sizeof(ticks));
+	write(&count, sizeof(count));
+	
+	// Serialize the events field by field
+	buffer_.resize(events.size() * eventSize);
+	unsigned char* out = buffer_.data();
+	for (const InputEvent& event : events) {
+		out = put(out, event.type);
+		out = put(out, event.action);
+		out = put(out, event.mods);
+		out = put(out, event.code);
+		out = put(out, event.scancode);
+		out = put(out, event.x);
+		out = put(out, event.y);
+		out = put(out, event.timestamp);
+	}
+	write(buffer_.data(), buffer_.size());
+}
+
+void InputRecorder::write(const void* data, std::size_t size) {
+	file_.write(static_cast<const char*>(data), size);
+	if (!file_) {
+		throw std::runtime_error("Error writing input recording.");
+	}
+}
+
+
+/*******************************************************************
+ * InputReplay
+ *******************************************************************/
+
+// Constructor
+InputReplay::InputReplay(const char* filename)
+	: file_ {filename}
+{
+	char fileMagic[sizeof(magic)];
+	std::uint32_t fileVersion = 0;
+	if (!read(fileMagic, sizeof(fileMagic)) || std::memcmp(fileMagic, magic, sizeof(magic)) != 0
+		|| !read(&fileVersion, sizeof(fileVersion)) || !read(&timestep_, sizeof(timestep_)))
+	{
+		throw std::runtime_error("'" + std::string(filename) + "' is not an input recording.");
+	}
+	if (fileVersion != InputRecorder::version) {
+		throw std::runtime_error("Input recording '" + std::string(filename) + "' has unsupported version "
+			+ std::to_string(fileVersion) + ".");
+	}
+}
+
+bool InputReplay::readFrame(std::uint32_t& ticks, std::vector<InputEvent>& events) {
+	std::size_t start = position_;
+	std::uint32_t count = 0;
+	if (!read(&ticks, sizeof(ticks)) || !read(&count, sizeof(count))
+		|| file_.getSize() - position_ < count * eventSize)
+	{
+		position_ = start;
+		return false;
+	}
+	
+	// Deserialize the events field by field
+	const unsigned char* in = file_.getData() + position_;
+	for (std::uint32_t i = 0; i < count; ++i) {
+		InputEvent event {};
+		in = get(in, event.type);
+		in = get(in, event.action);
+		in = get(in, event.mods);
+		in = get(in, event.code);
+		in = get(in, event.scancode);
+		in = get(in, event.x);
+		in = get(in, event.y);
+		in = get(in, event.timestamp);
+		events.push_back(event);
+	}
+	position_ += count * eventSize;
+	return true;
+}
+
+bool InputReplay::read(void* data, std::size_t size) {
+	if (file_.getSize() - position_ < size) {
+		return false;
+	}
+	
+	// The mapping gives no alignment guarantees: copy
+	std::memcpy(data, file_.getData() + position_, size);
+	position_ += size;
+	return true;
+}
+
+} // end namespace bdEngine
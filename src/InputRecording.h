@@ -0,0 +1,115 @@
+#ifndef _BDENGINE_INPUTRECORDING_H
+#define _BDENGINE_INPUTRECORDING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+#include "InputQueue.h"
+#include "MappedFile.h"
+
+namespace bdEngine {
+
+/*!
+ * Writes the input of every frame to a file, so that a session can be
+ * replayed exactly (see InputReplay).
+ *
+ * A frame consists of the number of fixed timestep ticks simulated in it
+ * and the input events applied before them. The file starts with the magic
+ * "BDIR", a format version and the timestep, followed by the frames (all
+ * in native byte order). Events are written field by field, so neither
+ * struct padding nor the compiler's struct layout ends up in the file.
+ */
+class InputRecorder {
+public:
+	/*! Version of the file format. */
+	static const std::uint32_t version = 2;
+	
+	
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates the file. Throws std::runtime_error if that fails.
+	 */
+	InputRecorder(const char* filename, float timestep);
+	
+	// --- Forbid copy and move operations
+	InputRecorder(const InputRecorder& other)            = delete;  // copy constructor
+	InputRecorder& operator=(const InputRecorder& other) = delete;  // copy assignment
+	InputRecorder(InputRecorder&& other)                 = delete;  // move constructor
+	InputRecorder& operator=(InputRecorder&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Recording
+	 *******************************************************************/
+	/*!
+	 * Appends a frame. Throws std::runtime_error if writing fails.
+	 */
+	void writeFrame(std::uint32_t ticks, const std::vector<InputEvent>& events);
+
+private:
+	// Writes raw bytes
+	void write(const void* data, std::size_t size);
+	
+	std::ofstream file_;
+	
+	// Serialized events of a frame (reused)
+	std::vector<unsigned char> buffer_;
+};
+
+/*!
+ * Reads a file written by InputRecorder, frame by frame.
+ *
+ * The whole file is mapped when it is opened, so replaying does no I/O.
+ */
+class InputReplay {
+public:
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Opens a recording. Throws std::runtime_error if it can't be opened
+	 * or is not a recording of the current version.
+	 */
+	InputReplay(const char* filename);
+	
+	// --- Forbid copy and move operations
+	InputReplay(const InputReplay& other)            = delete;  // copy constructor
+	InputReplay& operator=(const InputReplay& other) = delete;  // copy assignment
+	InputReplay(InputReplay&& other)                 = delete;  // move constructor
+	InputReplay& operator=(InputReplay&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Replaying
+	 *******************************************************************/
+	/*!
+	 * Returns the fixed timestep of the recorded session in seconds.
+	 */
+	float getTimestep() const {
+		return timestep_;
+	}
+	
+	/*!
+	 * Reads the next frame: its number of ticks, and its events, which are
+	 * appended to events. Returns false at the end of the recording (or if
+	 * the last frame is truncated).
+	 */
+	bool readFrame(std::uint32_t& ticks, std::vector<InputEvent>& events);
+
+private:
+	// Copies size bytes at the read position to data, returns false if the
+	// file ends before
+	bool read(void* data, std::size_t size);
+	
+	MappedFile file_;
+	std::size_t position_ = 0;
+	float timestep_ = 0.0f;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_INPUTRECORDING_H */
@@ -0,0 +1,98 @@
+#include "InputState.h"
+
+namespace bdEngine {
+
+const std::size_t InputState::keyCount;
+const std::size_t InputState::mouseButtonCount;
+const std::size_t InputState::joystickButtonCount;
+const std::size_t InputState::joystickAxisCount;
+
+
+/*******************************************************************
+ * Updating
+ *******************************************************************/
+
+void InputState::beginFrame() {
+	keysPressed_.reset();
+	keysReleased_.reset();
+	mouseButtonsPressed_.reset();
+	mouseButtonsReleased_.reset();
+	cursorDelta_ = Vec2();
+	scrollDelta_ = Vec2();
+	joystickButtonsPressed_.reset();
+	joystickButtonsReleased_.reset();
+}
+
+void InputState::handleEvent(const InputEvent& event) {
+	GLFW::InputAction action = static_cast<GLFW::InputAction>(event.action);
+	
+	switch (event.type) {
+	case InputEventType::Key:
+		// Repeats don't change the state, unknown keys (-1) are ignored
+		if (event.code < 0 || static_cast<std::size_t>(event.code) >= keyCount) {
+			break;
+		}
+		if (action == GLFW::InputAction::Press) {
+			keysDown_.set(event.code);
+			keysPressed_.set(event.code);
+		}
+		else if (action == GLFW::InputAction::Release) {
+			keysDown_.reset(event.code);
+			keysReleased_.set(event.code);
+		}
+		break;
+	
+	case InputEventType::MouseButton:
+		if (event.code < 0 || static_cast<std::size_t>(event.code) >= mouseButtonCount) {
+			break;
+		}
+		if (action == GLFW::InputAction::Press) {
+			mouseButtonsDown_.set(event.code);
+			mouseButtonsPressed_.set(event.code);
+		}
+		else if (action == GLFW::InputAction::Release) {
+			mouseButtonsDown_.reset(event.code);
+			mouseButtonsReleased_.set(event.code);
+		}
+		break;
+	
+	case InputEventType::CursorPos: {
+		Vec2 position {event.x, event.y};
+		if (cursorKnown_) {
+			cursorDelta_ += position - cursorPosition_;
+		}
+		cursorPosition_ = position;
+		cursorKnown_ = true;
+		break;
+	}
+	
+	case InputEventType::Scroll:
+		scrollDelta_ += Vec2 {event.x, event.y};
+		break;
+	
+	case InputEventType::JoystickButton:
+		if (event.code < 0 || static_cast<std::size_t>(event.code) >= joystickButtonCount) {
+			break;
+		}
+		if (action == GLFW::InputAction::Press) {
+			joystickButtonsDown_.set(event.code);
+			joystickButtonsPressed_.set(event.code);
+		}
+		else {
+			joystickButtonsDown_.reset(event.code);
+			joystickButtonsReleased_.set(event.code);
+		}
+		break;
+	
+	case InputEventType::JoystickAxis:
+		if (event.code >= 0 && static_cast<std::size_t>(event.code) < joystickAxisCount) {
+			joystickAxes_[event.code] = event.x;
+		}
+		break;
+	
+	default:
+		break;
+	}
+}
+
+} // end namespace bdEngine
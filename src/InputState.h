@@ -0,0 +1,273 @@
+#ifndef _BDENGINE_INPUTSTATE_H
+#define _BDENGINE_INPUTSTATE_H
+
+// GLEW has to be included *before* GLFW or any other OpenGL header.
+#include <GL/glew.h>
+#include "GLFWpp.h"
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "InputQueue.h"
+#include "Math.h"
+
+namespace bdEngine {
+
+/*!
+ * Snapshot of keyboard, mouse and joystick state, updated once per frame
+ * from input events.
+ *
+ * Keys and buttons are kept in bitsets: whether they are down, and whether
+ * they were pressed or released during the current frame (both can be set
+ * if a key was tapped within one frame). All queries are O(1) bit tests.
+ */
+class InputState {
+public:
+	static const std::size_t keyCount = 512;
+	static const std::size_t mouseButtonCount = 8;
+	static const std::size_t joystickButtonCount = 32;
+	static const std::size_t joystickAxisCount = 8;
+	
+	
+	/*******************************************************************
+	 * Updating
+	 *******************************************************************/
+	/*!
+	 * Starts a new frame: clears edges and deltas.
+	 */
+	void beginFrame();
+	
+	/*!
+	 * Applies one event (see InputQueue).
+	 */
+	void handleEvent(const InputEvent& event);
+	
+	/*******************************************************************
+	 * Keyboard
+	 *******************************************************************/
+	bool isKeyDown(GLFW::KeyCode key) const {
+		return testBit(keysDown_, static_cast<int>(key));
+	}
+	
+	bool wasKeyPressed(GLFW::KeyCode key) const {
+		return testBit(keysPressed_, static_cast<int>(key));
+	}
+	
+	bool wasKeyReleased(GLFW::KeyCode key) const {
+		return testBit(keysReleased_, static_cast<int>(key));
+	}
+	
+	
+	/*******************************************************************
+	 * Mouse
+	 *******************************************************************/
+	bool isMouseButtonDown(GLFW::MouseButton button) const {
+		return testBit(mouseButtonsDown_, static_cast<int>(button));
+	}
+	
+	bool wasMouseButtonPressed(GLFW::MouseButton button) const {
+		return testBit(mouseButtonsPressed_, static_cast<int>(button));
+	}
+	
+	bool wasMouseButtonReleased(GLFW::MouseButton button) const {
+		return testBit(mouseButtonsReleased_, static_cast<int>(button));
+	}
+	
+	/*!
+	 * Returns the cursor position in screen coordinates.
+	 */
+	const Vec2& getCursorPosition() const {
+		return cursorPosition_;
+	}
+	
+	/*!
+	 * Returns how far the cursor moved during this frame.
+	 */
+	const Vec2& getCursorDelta() const {
+		return cursorDelta_;
+	}
+	
+	/*!
+	 * Returns the scroll offset of this frame.
+	 */
+	const Vec2& getScrollDelta() const {
+		return scrollDelta_;
+	}
+	
+	
+	/*******************************************************************
+	 * Joystick
+	 *******************************************************************/
+	bool isJoystickButtonDown(std::size_t button) const {
+		return button < joystickButtonCount && joystickButtonsDown_[button];
+	}
+	
+	bool wasJoystickButtonPressed(std::size_t button) const {
+		return button < joystickButtonCount && joystickButtonsPressed_[button];
+	}
+	
+	bool wasJoystickButtonReleased(std::size_t button) const {
+		return button < joystickButtonCount && joystickButtonsReleased_[button];
+	}
+	
+	/*!
+	 * Returns the position of an axis in [-1, 1] (0 for unknown axes).
+	 */
+	float getJoystickAxis(std::size_t axis) const {
+		return axis < joystickAxisCount ? joystickAxes_[axis] : 0.0f;
+	}
+
+private:
+	template <std::size_t size>
+	static bool testBit(const std::bitset<size>& bits, int index) {
+		return index >= 0 && static_cast<std::size_t>(index) < size && bits[index];
+	}
+	
+	// Keyboard
+	std::bitset<keyCount> keysDown_;
+	std::bitset<keyCount> keysPressed_;
+	std::bitset<keyCount> keysReleased_;
+	
+	// Mouse
+	std::bitset<mouseButtonCount> mouseButtonsDown_;
+	std::bitset<mouseButtonCount> mouseButtonsPressed_;
+	std::bitset<mouseButtonCount> mouseButtonsReleased_;
+	Vec2 cursorPosition_;
+	Vec2 cursorDelta_;
+	Vec2 scrollDelta_;
+	bool cursorKnown_ = false;
+	
+	// Joystick
+	std::bitset<joystickButtonCount> joystickButtonsDown_;
+	std::bitset<joystickButtonCount> joystickButtonsPressed_;
+	std::bitset<joystickButtonCount> joystickButtonsReleased_;
+	float joystickAxes_[joystickAxisCount] = {};
+};
+
+/*!
+ * Key, mouse button or joystick button that can trigger an action.
+ */
+struct InputBinding {
+	enum class Device : std::uint8_t {
+		Keyboard,
+		Mouse,
+		Joystick,
+	};
+	
+	Device device;
+	std::int32_t code;
+	
+	static InputBinding key(GLFW::KeyCode key) {
+		return InputBinding {Device::Keyboard, static_cast<std::int32_t>(key)};
+	}
+	
+	static InputBinding mouseButton(GLFW::MouseButton button) {
+		return InputBinding {Device::Mouse, static_cast<std::int32_t>(button)};
+	}
+	
+	static InputBinding joystickButton(std::size_t button) {
+		return InputBinding {Device::Joystick, static_cast<std::int32_t>(button)};
+	}
+};
+
+/*!
+ * Maps actions (values of an enum starting at 0) to any number of input
+ * bindings, so that game logic asks for actions instead of keys.
+ */
+template <class Action>
+class ActionMap {
+public:
+	/*!
+	 * Adds a binding that triggers an action.
+	 */
+	void bind(Action action, InputBinding binding) {
+		std::size_t index = static_cast<std::size_t>(action);
+		if (index >= bindings_.size()) {
+			bindings_.resize(index + 1);
+		}
+		bindings_[index].push_back(binding);
+	}
+	
+	/*!
+	 * Removes all bindings of an action.
+	 */
+	void unbind(Action action) {
+		std::size_t index = static_cast<std::size_t>(action);
+		if (index < bindings_.size()) {
+			bindings_[index].clear();
+		}
+	}
+	
+	/*!
+	 * Returns true if any binding of the action is down.
+	 */
+	bool isDown(const InputState& input, Action action) const {
+		return any(action, [&input](const InputBinding& binding) {
+			switch (binding.device) {
+			case InputBinding::Device::Keyboard:
+				return input.isKeyDown(static_cast<GLFW::KeyCode>(binding.code));
+			case InputBinding::Device::Mouse:
+				return input.isMouseButtonDown(static_cast<GLFW::MouseButton>(binding.code));
+			default:
+				return input.isJoystickButtonDown(binding.code);
+			}
+		});
+	}
+	
+	/*!
+	 * Returns true if any binding of the action was pressed in this frame.
+	 */
+	bool wasPressed(const InputState& input, Action action) const {
+		return any(action, [&input](const InputBinding& binding) {
+			switch (binding.device) {
+			case InputBinding::Device::Keyboard:
+				return input.wasKeyPressed(static_cast<GLFW::KeyCode>(binding.code));
+			case InputBinding::Device::Mouse:
+				return input.wasMouseButtonPressed(static_cast<GLFW::MouseButton>(binding.code));
+			default:
+				return input.wasJoystickButtonPressed(binding.code);
+			}
+		});
+	}
+	
+	/*!
+	 * Returns true if any binding of the action was released in this frame.
+	 */
+	bool wasReleased(const InputState& input, Action action) const {
+		return any(action, [&input](const InputBinding& binding) {
+			switch (binding.device) {
+			case InputBinding::Device::Keyboard:
+				return input.wasKeyReleased(static_cast<GLFW::KeyCode>(binding.code));
+			case InputBinding::Device::Mouse:
+				return input.wasMouseButtonReleased(static_cast<GLFW::MouseButton>(binding.code));
+			default:
+				return input.wasJoystickButtonReleased(binding.code);
+			}
+		});
+	}
+
+private:
+	// Returns true if test returns true for any binding of the action
+	template <class Test>
+	bool any(Action action, Test test) const {
+		std::size_t index = static_cast<std::size_t>(action);
+		if (index >= bindings_.size()) {
+			return false;
+		}
+		for (const InputBinding& binding : bindings_[index]) {
+			if (test(binding)) {
+				return true;
+			}
+		}
+		return false;
+	}
+	
+	// Bindings by action
+	std::vector<std::vector<InputBinding>> bindings_;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_INPUTSTATE_H */
@@ -0,0 +1,150 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+JobSystem::JobSystem(unsigned int workerCount) {
+	if (workerCount == 0) {
+		// One worker per hardware thread, the calling thread is the last one.
+		// (hardware_concurrency() may return 0 if unknown.)
+		unsigned int hwThreads = std::thread::hardware_concurrency();
+		workerCount = (hwThreads > 1 ? hwThreads - 1 : 0);
+	}
+	
+	// Start worker threads
+	for (unsigned int i = 0; i < workerCount; ++i) {
+		workers_.emplace_back(&JobSystem::workerLoop, this);
+	}
+}
+
+// Destructor
+JobSystem::~JobSystem() {
+	// Signal workers to stop after the queue has been emptied
+	{
+		std::lock_guard<std::mutex> lock {queueMutex_};
+		stopping_ = true;
+	}
+	queueCondition_.notify_all();
+	
+	for (auto& worker : workers_) {
+		worker.join();
+	}
+}
+
+
+/*******************************************************************
+ * Jobs
+ *******************************************************************/
+
+void JobSystem::submit(std::function<void()> job) {
+	if (workers_.empty()) {
+		// Nobody to hand the job to, run it right away.
+		job();
+		return;
+	}
+	
+	{
+		std::lock_guard<std::mutex> lock {queueMutex_};
+		queue_.push_back(std::move(job));
+	}
+	queueCondition_.notify_one();
+}
+
+void JobSystem::parallelFor(std::size_t count, std::size_t grainSize,
+	const std::function<void(std::size_t, std::size_t)>& func)
+{
+	if (count == 0) {
+		return;
+	}
+	
+	grainSize = std::max<std::size_t>(grainSize, 1);
+	const std::size_t rangeCount = (count + grainSize - 1) / grainSize;
+	
+	if (rangeCount == 1 || workers_.empty()) {
+		// Not worth distributing (or nobody to distribute to)
+		func(0, count);
+		return;
+	}
+	
+	// Shared state of this loop. Helper jobs may be started by a worker
+	// after the loop has already finished, so they hold a reference to it.
+	struct LoopState {
+		std::atomic<std::size_t> nextRange {0};
+		std::atomic<std::size_t> doneRanges {0};
+		std::mutex doneMutex;
+		std::condition_variable doneCondition;
+	};
+	auto state = std::make_shared<LoopState>();
+	
+	// Grabs and processes ranges until none are left. func is only called
+	// for a grabbed range, which guarantees that parallelFor() hasn't
+	// returned yet and func is still valid.
+	auto processRanges = [state, count, grainSize, rangeCount, &func]() {
+		std::size_t range;
+		while ((range = state->nextRange++) < rangeCount) {
+			std::size_t begin = range * grainSize;
+			func(begin, std::min(begin + grainSize, count));
+			
+			if (++state->doneRanges == rangeCount) {
+				std::lock_guard<std::mutex> lock {state->doneMutex};
+				state->doneCondition.notify_all();
+			}
+		}
+	};
+	
+	// Wake up as many helpers as there are ranges left for them
+	std::size_t helperCount = std::min<std::size_t>(workers_.size(), rangeCount - 1);
+	{
+		std::lock_guard<std::mutex> lock {queueMutex_};
+		for (std::size_t i = 0; i < helperCount; ++i) {
+			queue_.push_back(processRanges);
+		}
+	}
+	queueCondition_.notify_all();
+	
+	// Take part in the work ourselves, then wait for the ranges still in progress
+	processRanges();
+	
+	std::unique_lock<std::mutex> lock {state->doneMutex};
+	state->doneCondition.wait(lock, [&state, rangeCount]() {
+		return state->doneRanges == rangeCount;
+	});
+}
+
+
+/*******************************************************************
+ * Worker threads
+ *******************************************************************/
+
+void JobSystem::workerLoop() {
+	while (true) {
+		std::function<void()> job;
+		
+		{
+			std::unique_lock<std::mutex> lock {queueMutex_};
+			queueCondition_.wait(lock, [this]() {
+				return stopping_ || !queue_.empty();
+			});
+			
+			if (queue_.empty()) {
+				// Stopping and nothing left to do
+				return;
+			}
+			
+			job = std::move(queue_.front());
+			queue_.pop_front();
+		}
+		
+		job();
+	}
+}
+
+} // end namespace bdEngine
@@ -0,0 +1,97 @@
+#ifndef _BDENGINE_JOBSYSTEM_H
+#define _BDENGINE_JOBSYSTEM_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MemoryStats.h"
+
+namespace bdEngine {
+
+/*!
+ * Small pool of worker threads that executes jobs (plain function objects).
+ *
+ * Jobs can either be submitted fire-and-forget with submit() or be used to
+ * split a loop over a range of indices with parallelFor(), which blocks until
+ * every index has been processed. The calling thread takes part in the work
+ * of parallelFor(), so it is safe to call with zero worker threads (the loop
+ * then simply runs on the calling thread) and from within a job.
+ */
+class JobSystem {
+public:
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	
+	/*!
+	 * Starts the given number of worker threads. If workerCount is 0, one
+	 * worker per hardware thread (minus the calling thread) is started.
+	 */
+	explicit JobSystem(unsigned int workerCount = 0);
+	
+	/*!
+	 * Finishes all pending jobs and stops the worker threads.
+	 */
+	~JobSystem();
+	
+	// --- Forbid copy and move operations
+	JobSystem(const JobSystem& other)            = delete;  // copy constructor
+	JobSystem& operator=(const JobSystem& other) = delete;  // copy assignment
+	JobSystem(JobSystem&& other)                 = delete;  // move constructor
+	JobSystem& operator=(JobSystem&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Jobs
+	 *******************************************************************/
+	
+	/*!
+	 * Queues a job to be executed on a worker thread. If there are no
+	 * worker threads, the job is executed immediately.
+	 */
+	void submit(std::function<void()> job);
+	
+	/*!
+	 * Calls func(begin, end) for consecutive ranges of [0, count), each at
+	 * most grainSize indices long, distributed over the worker threads and
+	 * the calling thread. Returns when all ranges have been processed.
+	 */
+	void parallelFor(std::size_t count, std::size_t grainSize,
+		const std::function<void(std::size_t, std::size_t)>& func);
+	
+	
+	/*******************************************************************
+	 * Properties
+	 *******************************************************************/
+	
+	/*!
+	 * Returns the number of worker threads (not counting the caller).
+	 */
+	unsigned int getWorkerCount() const {
+		return static_cast<unsigned int>(workers_.size());
+	}
+
+private:
+	// Worker thread main function
+	void workerLoop();
+	
+	// Worker threads
+	std::vector<std::thread> workers_;
+	
+	// Job queue, protected by queueMutex_
+	std::deque<std::function<void()>, TrackingAllocator<std::function<void()>, MemoryTag::Jobs>> queue_;
+	std::mutex queueMutex_;
+	std::condition_variable queueCondition_;
+	
+	// Set on destruction to stop the workers
+	bool stopping_ = false;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_JOBSYSTEM_H */
@@ -0,0 +1,115 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BDENGINE_MAPPEDFILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+MappedFile::MappedFile(const char* filename) {
+#ifdef BDENGINE_MAPPEDFILE_MMAP
+	int fd = open(filename, O_RDONLY);
+	if (fd < 0) {
+		throw std::runtime_error("Cannot open file '" + std::string(filename) + "'.");
+	}
+	
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0) {
+		close(fd);
+		throw std::runtime_error("Cannot stat file '" + std::string(filename) + "'.");
+	}
+	size_ = static_cast<std::size_t>(fileStat.st_size);
+	
+	if (size_ > 0) {
+		void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping == MAP_FAILED) {
+			close(fd);
+			throw std::runtime_error("Cannot map file '" + std::string(filename) + "'.");
+		}
+		data_ = static_cast<const unsigned char*>(mapping);
+	}
+	
+	// The mapping stays valid after closing the descriptor
+	close(fd);
+#else
+	std::ifstream file {filename, std::ios::binary | std::ios::ate};
+	if (!file) {
+		throw std::runtime_error("Cannot open file '" + std::string(filename) + "'.");
+	}
+	
+	buffer_.resize(static_cast<std::size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(buffer_.data()), buffer_.size());
+	
+	data_ = buffer_.data();
+	size_ = buffer_.size();
+#endif
+}
+
+// Destructor
+MappedFile::~MappedFile() {
+	unmap();
+}
+
+// Move constructor
+MappedFile::MappedFile(MappedFile&& other)
+	: data_ {other.data_}
+	, size_ {other.size_}
+	, buffer_ {std::move(other.buffer_)}
+{
+	// Reset other object so that the destructor doesn't unmap the (moved) mapping.
+	other.data_ = nullptr;
+	other.size_ = 0;
+}
+
+// Move assignment
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+	if (this != &other) {
+		// First, release the current mapping.
+		unmap();
+		
+		// Now, take over the mapping of the source object.
+		data_ = other.data_;
+		size_ = other.size_;
+		buffer_ = std::move(other.buffer_);
+		
+		// Reset other object so that the destructor doesn't unmap the (moved) mapping.
+		other.data_ = nullptr;
+		other.size_ = 0;
+	}
+	
+	return *this;
+}
+
+
+/*******************************************************************
+ * Internal helpers
+ *******************************************************************/
+
+void MappedFile::unmap() {
+#ifdef BDENGINE_MAPPEDFILE_MMAP
+	if (data_ != nullptr) {
+		munmap(const_cast<unsigned char*>(data_), size_);
+	}
+#endif
+
+	data_ = nullptr;
+	size_ = 0;
+	buffer_.clear();
+}
+
+} // end namespace bdEngine
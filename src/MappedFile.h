@@ -0,0 +1,77 @@
+#ifndef _BDENGINE_MAPPEDFILE_H
+#define _BDENGINE_MAPPEDFILE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace bdEngine {
+
+/*!
+ * Read-only view of a whole file in memory.
+ *
+ * On POSIX systems the file is memory mapped, so its pages are only read
+ * when they are accessed and no copy of the file is made. Elsewhere, the file
+ * is read into a buffer.
+ */
+class MappedFile {
+public:
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Default constructor. Maps nothing, getData() will return nullptr.
+	 */
+	MappedFile() {}
+	
+	/*!
+	 * Maps a file. Throws std::runtime_error if the file can't be opened.
+	 */
+	MappedFile(const char* filename);
+	
+	/*!
+	 * Unmaps the file.
+	 */
+	~MappedFile();
+	
+	// --- Forbid copy operations
+	MappedFile(const MappedFile& other)            = delete;  // copy constructor
+	MappedFile& operator=(const MappedFile& other) = delete;  // copy assignment
+	
+	// --- Override move operations
+	MappedFile(MappedFile&& other);             // move constructor
+	MappedFile& operator=(MappedFile&& other);  // move assignment
+	
+	
+	/*******************************************************************
+	 * Properties
+	 *******************************************************************/
+	/*!
+	 * Returns the pointer to the file contents.
+	 * This data is only available as long as this object exists!
+	 */
+	const unsigned char* getData() const {
+		return data_;
+	}
+	
+	/*!
+	 * Returns the file size in bytes.
+	 */
+	std::size_t getSize() const {
+		return size_;
+	}
+
+private:
+	// Releases the mapping
+	void unmap();
+	
+	// File contents and size
+	const unsigned char* data_ = nullptr;
+	std::size_t size_ = 0;
+	
+	// File contents if the file could not be mapped
+	std::vector<unsigned char> buffer_;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_MAPPEDFILE_H */
@@ -0,0 +1,334 @@
+#include "Math.h"
+
+#include <algorithm>
+#include <utility>
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+namespace bdEngine {
+
+static_assert(sizeof(Vec3) == 3 * sizeof(float), "Vec3 arrays have to be tightly packed.");
+
+/*******************************************************************
+ * Quaternions
+ *******************************************************************/
+
+Quat slerp(const Quat& a, const Quat& b, float t) {
+	float cosTheta = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+	
+	// Take the shorter way around
+	Quat c = b;
+	if (cosTheta < 0) {
+		c = Quat {-b.x, -b.y, -b.z, -b.w};
+		cosTheta = -cosTheta;
+	}
+	
+	// Nearly identical rotations: linear interpolation is accurate enough
+	float wa, wb;
+	if (cosTheta > 0.9995f) {
+		wa = 1 - t;
+		wb = t;
+	}
+	else {
+		float theta = std::acos(cosTheta);
+		float sinTheta = std::sin(theta);
+		wa = std::sin((1 - t) * theta) / sinTheta;
+		wb = std::sin(t * theta) / sinTheta;
+	}
+	
+	return normalize(Quat {
+		wa * a.x + wb * c.x,
+		wa * a.y + wb * c.y,
+		wa * a.z + wb * c.z,
+		wa * a.w + wb * c.w,
+	});
+}
+
+
+/*******************************************************************
+ * Mat3
+ *******************************************************************/
+
+Mat3 transpose(const Mat3& a) {
+	return Mat3 {{
+		a.m[0], a.m[3], a.m[6],
+		a.m[1], a.m[4], a.m[7],
+		a.m[2], a.m[5], a.m[8],
+	}};
+}
+
+Mat3 inverse(const Mat3& a) {
+	// Adjugate divided by determinant
+	const float* m = a.m;
+	Mat3 r {{
+		m[4] * m[8] - m[7] * m[5],
+		m[7] * m[2] - m[1] * m[8],
+		m[1] * m[5] - m[4] * m[2],
+		m[6] * m[5] - m[3] * m[8],
+		m[0] * m[8] - m[6] * m[2],
+		m[3] * m[2] - m[0] * m[5],
+		m[3] * m[7] - m[6] * m[4],
+		m[6] * m[1] - m[0] * m[7],
+		m[0] * m[4] - m[3] * m[1],
+	}};
+	
+	float invDet = 1.0f / (m[0] * r.m[0] + m[3] * r.m[1] + m[6] * r.m[2]);
+	for (float& value : r.m) {
+		value *= invDet;
+	}
+	return r;
+}
+
+
+/*******************************************************************
+ * Mat4
+ *******************************************************************/
+
+Mat4 Mat4::orthographic(float left, float right, float bottom, float top, float zNear, float zFar) {
+	return Mat4 {{
+		2 / (right - left),               0,                                0,                               0,
+		0,                                2 / (top - bottom),               0,                               0,
+		0,                                0,                                -2 / (zFar - zNear),             0,
+		-(right + left) / (right - left), -(top + bottom) / (top - bottom), -(zFar + zNear) / (zFar - zNear), 1,
+	}};
+}
+
+Mat4 Mat4::perspective(float fovY, float aspect, float zNear, float zFar) {
+	float f = 1 / std::tan(fovY / 2);
+	return Mat4 {{
+		f / aspect, 0, 0,                                  0,
+		0,          f, 0,                                  0,
+		0,          0, (zFar + zNear) / (zNear - zFar),     -1,
+		0,          0, 2 * zFar * zNear / (zNear - zFar),  0,
+	}};
+}
+
+Mat4 Mat4::lookAt(const Vec3& eye, const Vec3& target, const Vec3& up) {
+	Vec3 f = normalize(target - eye);
+	Vec3 s = normalize(cross(f, up));
+	Vec3 u = cross(s, f);
+	
+	return Mat4 {{
+		s.x,           u.x,           -f.x,         0,
+		s.y,           u.y,           -f.y,         0,
+		s.z,           u.z,           -f.z,         0,
+		-dot(s, eye),  -dot(u, eye),  dot(f, eye),  1,
+	}};
+}
+
+Mat4 transpose(const Mat4& a) {
+	Mat4 result = a;
+#ifdef __SSE__
+	__m128 c0 = _mm_load_ps(&result.m[0]);
+	__m128 c1 = _mm_load_ps(&result.m[4]);
+	__m128 c2 = _mm_load_ps(&result.m[8]);
+	__m128 c3 = _mm_load_ps(&result.m[12]);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+	_mm_store_ps(&result.m[0], c0);
+	_mm_store_ps(&result.m[4], c1);
+	_mm_store_ps(&result.m[8], c2);
+	_mm_store_ps(&result.m[12], c3);
+#else
+	for (int col = 0; col < 4; ++col) {
+		for (int row = 0; row < 4; ++row) {
+			result.m[col * 4 + row] = a.m[row * 4 + col];
+		}
+	}
+#endif
+	return result;
+}
+
+Mat4 inverse(const Mat4& a) {
+	// Cofactor expansion using 2x2 sub-determinants
+	const float* m = a.m;
+	
+	float s0 = m[0] * m[5] - m[4] * m[1];
+	float s1 = m[0] * m[9] - m[8] * m[1];
+	float s2 = m[0] * m[13] - m[12] * m[1];
+	float s3 = m[4] * m[9] - m[8] * m[5];
+	float s4 = m[4] * m[13] - m[12] * m[5];
+	float s5 = m[8] * m[13] - m[12] * m[9];
+	
+	float c5 = m[10] * m[15] - m[14] * m[11];
+	float c4 = m[6] * m[15] - m[14] * m[7];
+	float c3 = m[6] * m[11] - m[10] * m[7];
+	float c2 = m[2] * m[15] - m[14] * m[3];
+	float c1 = m[2] * m[11] - m[10] * m[3];
+	float c0 = m[2] * m[7] - m[6] * m[3];
+	
+	float invDet = 1.0f / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+	
+	// (Indices are transposed relative to the row-major textbook formula,
+	// which yields the inverse of the transposed matrix, transposed.)
+	Mat4 r;
+	r.m[0]  = ( m[5] * c5 - m[9] * c4 + m[13] * c3) * invDet;
+	r.m[4]  = (-m[4] * c5 + m[8] * c4 - m[12] * c3) * invDet;
+	r.m[8]  = ( m[7] * s5 - m[11] * s4 + m[15] * s3) * invDet;
+	r.m[12] = (-m[6] * s5 + m[10] * s4 - m[14] * s3) * invDet;
+	
+	r.m[1]  = (-m[1] * c5 + m[9] * c2 - m[13] * c1) * invDet;
+	r.m[5]  = ( m[0] * c5 - m[8] * c2 + m[12] * c1) * invDet;
+	r.m[9]  = (-m[3] * s5 + m[11] * s2 - m[15] * s1) * invDet;
+	r.m[13] = ( m[2] * s5 - m[10] * s2 + m[14] * s1) * invDet;
+	
+	r.m[2]  = ( m[1] * c4 - m[5] * c2 + m[13] * c0) * invDet;
+	r.m[6]  = (-m[0] * c4 + m[4] * c2 - m[12] * c0) * invDet;
+	r.m[10] = ( m[3] * s4 - m[7] * s2 + m[15] * s0) * invDet;
+	r.m[14] = (-m[2] * s4 + m[6] * s2 - m[14] * s0) * invDet;
+	
+	r.m[3]  = (-m[1] * c3 + m[5] * c1 - m[9] * c0) * invDet;
+	r.m[7]  = ( m[0] * c3 - m[4] * c1 + m[8] * c0) * invDet;
+	r.m[11] = (-m[3] * s3 + m[7] * s1 - m[11] * s0) * invDet;
+	r.m[15] = ( m[2] * s3 - m[6] * s1 + m[10] * s0) * invDet;
+	
+	return r;
+}
+
+
+/*******************************************************************
+ * Bounding boxes
+ *******************************************************************/
+
+AABB transformAABB(const Mat4& a, const AABB& box) {
+	// Transform the center, and project the extents onto each axis using
+	// the absolute values of the matrix (Arvo's method)
+	Vec3 center = transformPoint(a, box.getCenter());
+	Vec3 e = box.getExtents();
+	Vec3 extents {
+		std::fabs(a.m[0]) * e.x + std::fabs(a.m[4]) * e.y + std::fabs(a.m[8]) * e.z,
+		std::fabs(a.m[1]) * e.x + std::fabs(a.m[5]) * e.y + std::fabs(a.m[9]) * e.z,
+		std::fabs(a.m[2]) * e.x + std::fabs(a.m[6]) * e.y + std::fabs(a.m[10]) * e.z,
+	};
+	return AABB {center - extents, center + extents};
+}
+
+bool intersectRay(const Rect& rect, const Vec2& origin, const Vec2& direction, float maxT, float& t) {
+	// Slab test: intersect the parameter intervals of both axes
+	float tMin = 0.0f;
+	float tMax = maxT;
+	const float o[2] = {origin.x, origin.y};
+	const float d[2] = {direction.x, direction.y};
+	const float lo[2] = {rect.min.x, rect.min.y};
+	const float hi[2] = {rect.max.x, rect.max.y};
+	
+	for (int axis = 0; axis < 2; ++axis) {
+		if (d[axis] == 0.0f) {
+			// Parallel to the slab: either always or never inside
+			if (o[axis] < lo[axis] || o[axis] > hi[axis]) {
+				return false;
+			}
+			continue;
+		}
+		
+		float inv = 1.0f / d[axis];
+		float t0 = (lo[axis] - o[axis]) * inv;
+		float t1 = (hi[axis] - o[axis]) * inv;
+		if (t0 > t1) {
+			std::swap(t0, t1);
+		}
+		tMin = std::max(tMin, t0);
+		tMax = std::min(tMax, t1);
+		if (tMin > tMax) {
+			return false;
+		}
+	}
+	
+	t = tMin;
+	return true;
+}
+
+
+/*******************************************************************
+ * Batch operations
+ *******************************************************************/
+
+void transformPoints(const Mat4& a, const Vec3* in, Vec3* out, std::size_t count) {
+	std::size_t i = 0;
+
+#ifdef __SSE__
+	// Four points at a time: deinterleave 12 floats into x, y and z
+	// vectors, transform, and interleave again
+	const float* m = a.m;
+	__m128 m0 = _mm_set1_ps(m[0]), m1 = _mm_set1_ps(m[1]), m2 = _mm_set1_ps(m[2]);
+	__m128 m4 = _mm_set1_ps(m[4]), m5 = _mm_set1_ps(m[5]), m6 = _mm_set1_ps(m[6]);
+	__m128 m8 = _mm_set1_ps(m[8]), m9 = _mm_set1_ps(m[9]), m10 = _mm_set1_ps(m[10]);
+	__m128 m12 = _mm_set1_ps(m[12]), m13 = _mm_set1_ps(m[13]), m14 = _mm_set1_ps(m[14]);
+	
+	for (; i + 4 <= count; i += 4) {
+		const float* src = &in[i].x;
+		__m128 v0 = _mm_loadu_ps(src);      // x0 y0 z0 x1
+		__m128 v1 = _mm_loadu_ps(src + 4);  // y1 z1 x2 y2
+		__m128 v2 = _mm_loadu_ps(src + 8);  // z2 x3 y3 z3
+		
+		__m128 x = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 2, 3, 0)),
+			_mm_shuffle_ps(v1, v2, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 1, 0));
+		__m128 y = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 1, 1)),
+			_mm_shuffle_ps(v1, v2, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+		__m128 z = _mm_shuffle_ps(_mm_shuffle_ps(v0, v1, _MM_SHUFFLE(1, 1, 2, 2)),
+			_mm_shuffle_ps(v2, v2, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+		
+		__m128 ox = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m0, x), _mm_mul_ps(m4, y)), _mm_add_ps(_mm_mul_ps(m8, z), m12));
+		__m128 oy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m1, x), _mm_mul_ps(m5, y)), _mm_add_ps(_mm_mul_ps(m9, z), m13));
+		__m128 oz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m2, x), _mm_mul_ps(m6, y)), _mm_add_ps(_mm_mul_ps(m10, z), m14));
+		
+		float* dst = &out[i].x;
+		_mm_storeu_ps(dst, _mm_shuffle_ps(_mm_shuffle_ps(ox, oy, _MM_SHUFFLE(0, 0, 0, 0)),
+			_mm_shuffle_ps(oz, ox, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(dst + 4, _mm_shuffle_ps(_mm_shuffle_ps(oy, oz, _MM_SHUFFLE(1, 1, 1, 1)),
+			_mm_shuffle_ps(ox, oy, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(dst + 8, _mm_shuffle_ps(_mm_shuffle_ps(oz, ox, _MM_SHUFFLE(3, 3, 2, 2)),
+			_mm_shuffle_ps(oy, oz, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+	}
+#endif
+
+	for (; i < count; ++i) {
+		const Vec3 p = in[i];
+		out[i] = Vec3 {
+			a.m[0] * p.x + a.m[4] * p.y + a.m[8] * p.z + a.m[12],
+			a.m[1] * p.x + a.m[5] * p.y + a.m[9] * p.z + a.m[13],
+			a.m[2] * p.x + a.m[6] * p.y + a.m[10] * p.z + a.m[14],
+		};
+	}
+}
+
+void transformVectors(const Mat4& a, const Vec4* in, Vec4* out, std::size_t count) {
+	for (std::size_t i = 0; i < count; ++i) {
+		out[i] = a * in[i];
+	}
+}
+
+void multiplyMatrices(const Mat4& a, const Mat4* b, Mat4* out, std::size_t count) {
+#ifdef __AVX__
+	// Two result columns per 256 bit register, with the columns of a
+	// duplicated into both halves
+	__m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a.m[0]));
+	__m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a.m[4]));
+	__m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a.m[8]));
+	__m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&a.m[12]));
+	
+	for (std::size_t i = 0; i < count; ++i) {
+		for (int col = 0; col < 4; col += 2) {
+			__m256 bc = _mm256_loadu_ps(&b[i].m[col * 4]);
+			__m256 sum = _mm256_mul_ps(a0, _mm256_shuffle_ps(bc, bc, _MM_SHUFFLE(0, 0, 0, 0)));
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(a1, _mm256_shuffle_ps(bc, bc, _MM_SHUFFLE(1, 1, 1, 1))));
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(a2, _mm256_shuffle_ps(bc, bc, _MM_SHUFFLE(2, 2, 2, 2))));
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(a3, _mm256_shuffle_ps(bc, bc, _MM_SHUFFLE(3, 3, 3, 3))));
+			_mm256_storeu_ps(&out[i].m[col * 4], sum);
+		}
+	}
+#else
+	for (std::size_t i = 0; i < count; ++i) {
+		out[i] = a * b[i];
+	}
+#endif
+}
+
+void multiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, std::size_t count) {
+	for (std::size_t i = 0; i < count; ++i) {
+		out[i] = a[i] * b[i];
+	}
+}
+
+} // end namespace bdEngine
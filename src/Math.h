@@ -0,0 +1,467 @@
+#ifndef _BDENGINE_MATH_H
+#define _BDENGINE_MATH_H
+
+#include <cmath>
+#include <cstddef>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Vectors
+ *******************************************************************/
+
+struct Vec2 {
+	float x = 0.0f;
+	float y = 0.0f;
+	
+	Vec2() {}
+	Vec2(float x, float y) : x {x}, y {y} {}
+	
+	Vec2& operator+=(const Vec2& v) { x += v.x; y += v.y; return *this; }
+	Vec2& operator-=(const Vec2& v) { x -= v.x; y -= v.y; return *this; }
+	Vec2& operator*=(float s) { x *= s; y *= s; return *this; }
+};
+
+inline Vec2 operator+(Vec2 a, const Vec2& b) { return a += b; }
+inline Vec2 operator-(Vec2 a, const Vec2& b) { return a -= b; }
+inline Vec2 operator-(const Vec2& v) { return Vec2 {-v.x, -v.y}; }
+inline Vec2 operator*(Vec2 v, float s) { return v *= s; }
+inline Vec2 operator*(float s, Vec2 v) { return v *= s; }
+inline Vec2 operator/(const Vec2& v, float s) { return Vec2 {v.x / s, v.y / s}; }
+
+inline float dot(const Vec2& a, const Vec2& b) { return a.x * b.x + a.y * b.y; }
+inline float length(const Vec2& v) { return std::sqrt(dot(v, v)); }
+inline Vec2 normalize(const Vec2& v) { return v / length(v); }
+
+
+struct Vec3 {
+	float x = 0.0f;
+	float y = 0.0f;
+	float z = 0.0f;
+	
+	Vec3() {}
+	Vec3(float x, float y, float z) : x {x}, y {y}, z {z} {}
+	
+	Vec3& operator+=(const Vec3& v) { x += v.x; y += v.y; z += v.z; return *this; }
+	Vec3& operator-=(const Vec3& v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+	Vec3& operator*=(float s) { x *= s; y *= s; z *= s; return *this; }
+};
+
+inline Vec3 operator+(Vec3 a, const Vec3& b) { return a += b; }
+inline Vec3 operator-(Vec3 a, const Vec3& b) { return a -= b; }
+inline Vec3 operator-(const Vec3& v) { return Vec3 {-v.x, -v.y, -v.z}; }
+inline Vec3 operator*(Vec3 v, float s) { return v *= s; }
+inline Vec3 operator*(float s, Vec3 v) { return v *= s; }
+inline Vec3 operator/(const Vec3& v, float s) { return Vec3 {v.x / s, v.y / s, v.z / s}; }
+
+inline float dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline float length(const Vec3& v) { return std::sqrt(dot(v, v)); }
+inline Vec3 normalize(const Vec3& v) { return v / length(v); }
+
+inline Vec3 cross(const Vec3& a, const Vec3& b) {
+	return Vec3 {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+
+/*!
+ * Four component vector, aligned so that it can be loaded into one SSE
+ * register.
+ */
+struct alignas(16) Vec4 {
+	float x = 0.0f;
+	float y = 0.0f;
+	float z = 0.0f;
+	float w = 0.0f;
+	
+	Vec4() {}
+	Vec4(float x, float y, float z, float w) : x {x}, y {y}, z {z}, w {w} {}
+	Vec4(const Vec3& v, float w) : x {v.x}, y {v.y}, z {v.z}, w {w} {}
+	
+	Vec3 xyz() const {
+		return Vec3 {x, y, z};
+	}
+};
+
+#ifdef __SSE__
+inline __m128 loadVec4(const Vec4& v) { return _mm_load_ps(&v.x); }
+inline Vec4 storeVec4(__m128 r) { Vec4 v; _mm_store_ps(&v.x, r); return v; }
+
+inline Vec4 operator+(const Vec4& a, const Vec4& b) { return storeVec4(_mm_add_ps(loadVec4(a), loadVec4(b))); }
+inline Vec4 operator-(const Vec4& a, const Vec4& b) { return storeVec4(_mm_sub_ps(loadVec4(a), loadVec4(b))); }
+inline Vec4 operator*(const Vec4& v, float s) { return storeVec4(_mm_mul_ps(loadVec4(v), _mm_set1_ps(s))); }
+#else
+inline Vec4 operator+(const Vec4& a, const Vec4& b) { return Vec4 {a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w}; }
+inline Vec4 operator-(const Vec4& a, const Vec4& b) { return Vec4 {a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w}; }
+inline Vec4 operator*(const Vec4& v, float s) { return Vec4 {v.x * s, v.y * s, v.z * s, v.w * s}; }
+#endif
+
+inline Vec4 operator*(float s, const Vec4& v) { return v * s; }
+inline float dot(const Vec4& a, const Vec4& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+
+/*******************************************************************
+ * Quaternions
+ *******************************************************************/
+
+/*!
+ * Rotation quaternion (x, y, z: vector part, w: scalar part).
+ */
+struct Quat {
+	float x = 0.0f;
+	float y = 0.0f;
+	float z = 0.0f;
+	float w = 1.0f;
+	
+	Quat() {}
+	Quat(float x, float y, float z, float w) : x {x}, y {y}, z {z}, w {w} {}
+	
+	/*!
+	 * Returns the rotation by angle (radians) around a normalized axis.
+	 */
+	static Quat fromAxisAngle(const Vec3& axis, float angle) {
+		float s = std::sin(angle / 2);
+		return Quat {axis.x * s, axis.y * s, axis.z * s, std::cos(angle / 2)};
+	}
+};
+
+/*!
+ * Quaternion product: the rotation b followed by a.
+ */
+inline Quat operator*(const Quat& a, const Quat& b) {
+	return Quat {
+		a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+		a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+		a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+		a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+	};
+}
+
+inline Quat conjugate(const Quat& q) {
+	return Quat {-q.x, -q.y, -q.z, q.w};
+}
+
+inline Quat normalize(const Quat& q) {
+	float s = 1.0f / std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+	return Quat {q.x * s, q.y * s, q.z * s, q.w * s};
+}
+
+/*!
+ * Rotates a vector by a (normalized) quaternion.
+ */
+inline Vec3 rotate(const Quat& q, const Vec3& v) {
+	// v + 2w(u x v) + 2u x (u x v), u = vector part
+	Vec3 u {q.x, q.y, q.z};
+	Vec3 t = 2.0f * cross(u, v);
+	return v + q.w * t + cross(u, t);
+}
+
+/*!
+ * Spherical linear interpolation between two normalized quaternions.
+ */
+Quat slerp(const Quat& a, const Quat& b, float t);
+
+
+/*******************************************************************
+ * Matrices
+ *******************************************************************/
+
+/*!
+ * 3x3 matrix, stored column-major (m[column * 3 + row]).
+ */
+struct Mat3 {
+	float m[9];
+	
+	static Mat3 identity() {
+		return Mat3 {{
+			1, 0, 0,
+			0, 1, 0,
+			0, 0, 1,
+		}};
+	}
+	
+	/*!
+	 * Returns the rotation matrix of a normalized quaternion.
+	 */
+	static Mat3 fromQuat(const Quat& r) {
+		float xx = r.x * r.x, yy = r.y * r.y, zz = r.z * r.z;
+		float xy = r.x * r.y, xz = r.x * r.z, yz = r.y * r.z;
+		float wx = r.w * r.x, wy = r.w * r.y, wz = r.w * r.z;
+		
+		return Mat3 {{
+			1 - 2 * (yy + zz), 2 * (xy + wz),     2 * (xz - wy),
+			2 * (xy - wz),     1 - 2 * (xx + zz), 2 * (yz + wx),
+			2 * (xz + wy),     2 * (yz - wx),     1 - 2 * (xx + yy),
+		}};
+	}
+	
+	const float* data() const {
+		return m;
+	}
+};
+
+inline Mat3 operator*(const Mat3& a, const Mat3& b) {
+	Mat3 result;
+	for (int col = 0; col < 3; ++col) {
+		for (int row = 0; row < 3; ++row) {
+			result.m[col * 3 + row] = a.m[row] * b.m[col * 3]
+				+ a.m[3 + row] * b.m[col * 3 + 1]
+				+ a.m[6 + row] * b.m[col * 3 + 2];
+		}
+	}
+	return result;
+}
+
+inline Vec3 operator*(const Mat3& a, const Vec3& v) {
+	return Vec3 {
+		a.m[0] * v.x + a.m[3] * v.y + a.m[6] * v.z,
+		a.m[1] * v.x + a.m[4] * v.y + a.m[7] * v.z,
+		a.m[2] * v.x + a.m[5] * v.y + a.m[8] * v.z,
+	};
+}
+
+Mat3 transpose(const Mat3& a);
+
+/*!
+ * Returns the inverse matrix. The matrix has to be invertible.
+ */
+Mat3 inverse(const Mat3& a);
+
+
+/*!
+ * 4x4 matrix, stored column-major like OpenGL expects it (m[column * 4 + row]).
+ */
+struct alignas(16) Mat4 {
+	float m[16];
+	
+	/*!
+	 * Returns the identity matrix.
+	 */
+	static Mat4 identity() {
+		return Mat4 {{
+			1, 0, 0, 0,
+			0, 1, 0, 0,
+			0, 0, 1, 0,
+			0, 0, 0, 1,
+		}};
+	}
+	
+	static Mat4 translation(const Vec3& t) {
+		return fromTRS(t, Quat {}, Vec3 {1, 1, 1});
+	}
+	
+	static Mat4 scaling(const Vec3& s) {
+		return fromTRS(Vec3 {}, Quat {}, s);
+	}
+	
+	static Mat4 rotation(const Quat& r) {
+		return fromTRS(Vec3 {}, r, Vec3 {1, 1, 1});
+	}
+	
+	/*!
+	 * Returns the matrix that scales, then rotates, then translates.
+	 */
+	static Mat4 fromTRS(const Vec3& t, const Quat& r, const Vec3& s) {
+		float xx = r.x * r.x, yy = r.y * r.y, zz = r.z * r.z;
+		float xy = r.x * r.y, xz = r.x * r.z, yz = r.y * r.z;
+		float wx = r.w * r.x, wy = r.w * r.y, wz = r.w * r.z;
+		
+		return Mat4 {{
+			(1 - 2 * (yy + zz)) * s.x, 2 * (xy + wz) * s.x,       2 * (xz - wy) * s.x,       0,
+			2 * (xy - wz) * s.y,       (1 - 2 * (xx + zz)) * s.y, 2 * (yz + wx) * s.y,       0,
+			2 * (xz + wy) * s.z,       2 * (yz - wx) * s.z,       (1 - 2 * (xx + yy)) * s.z, 0,
+			t.x,                       t.y,                       t.z,                       1,
+		}};
+	}
+	
+	/*!
+	 * Returns an orthographic projection (like glOrtho).
+	 */
+	static Mat4 orthographic(float left, float right, float bottom, float top, float zNear, float zFar);
+	
+	/*!
+	 * Returns a perspective projection with a vertical field of view in
+	 * radians (like gluPerspective).
+	 */
+	static Mat4 perspective(float fovY, float aspect, float zNear, float zFar);
+	
+	/*!
+	 * Returns a view matrix looking from eye at target.
+	 */
+	static Mat4 lookAt(const Vec3& eye, const Vec3& target, const Vec3& up);
+	
+	/*!
+	 * Returns a pointer to the 16 floats, e.g. for glUniformMatrix4fv().
+	 */
+	const float* data() const {
+		return m;
+	}
+};
+
+/*!
+ * Matrix product a * b (b is applied first).
+ */
+inline Mat4 operator*(const Mat4& a, const Mat4& b) {
+	Mat4 result;
+#ifdef __SSE__
+	// Each result column is a linear combination of the columns of a
+	__m128 a0 = _mm_load_ps(&a.m[0]);
+	__m128 a1 = _mm_load_ps(&a.m[4]);
+	__m128 a2 = _mm_load_ps(&a.m[8]);
+	__m128 a3 = _mm_load_ps(&a.m[12]);
+	
+	for (int col = 0; col < 4; ++col) {
+		const float* bc = &b.m[col * 4];
+		__m128 sum = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+		sum = _mm_add_ps(sum, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+		sum = _mm_add_ps(sum, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+		sum = _mm_add_ps(sum, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+		_mm_store_ps(&result.m[col * 4], sum);
+	}
+#else
+	for (int col = 0; col < 4; ++col) {
+		for (int row = 0; row < 4; ++row) {
+			result.m[col * 4 + row] = a.m[row] * b.m[col * 4]
+				+ a.m[4 + row] * b.m[col * 4 + 1]
+				+ a.m[8 + row] * b.m[col * 4 + 2]
+				+ a.m[12 + row] * b.m[col * 4 + 3];
+		}
+	}
+#endif
+	return result;
+}
+
+/*!
+ * Matrix-vector product.
+ */
+inline Vec4 operator*(const Mat4& a, const Vec4& v) {
+#ifdef __SSE__
+	__m128 sum = _mm_mul_ps(_mm_load_ps(&a.m[0]), _mm_set1_ps(v.x));
+	sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(&a.m[4]), _mm_set1_ps(v.y)));
+	sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(&a.m[8]), _mm_set1_ps(v.z)));
+	sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load_ps(&a.m[12]), _mm_set1_ps(v.w)));
+	return storeVec4(sum);
+#else
+	return Vec4 {
+		a.m[0] * v.x + a.m[4] * v.y + a.m[8] * v.z + a.m[12] * v.w,
+		a.m[1] * v.x + a.m[5] * v.y + a.m[9] * v.z + a.m[13] * v.w,
+		a.m[2] * v.x + a.m[6] * v.y + a.m[10] * v.z + a.m[14] * v.w,
+		a.m[3] * v.x + a.m[7] * v.y + a.m[11] * v.z + a.m[15] * v.w,
+	};
+#endif
+}
+
+/*!
+ * Transforms a point (w = 1, no perspective division).
+ */
+inline Vec3 transformPoint(const Mat4& a, const Vec3& p) {
+	return (a * Vec4 {p, 1.0f}).xyz();
+}
+
+/*!
+ * Transforms a direction (w = 0, ignores translation).
+ */
+inline Vec3 transformDirection(const Mat4& a, const Vec3& d) {
+	return (a * Vec4 {d, 0.0f}).xyz();
+}
+
+Mat4 transpose(const Mat4& a);
+
+/*!
+ * Returns the inverse matrix. The matrix has to be invertible.
+ */
+Mat4 inverse(const Mat4& a);
+
+
+/*******************************************************************
+ * Bounding boxes
+ *******************************************************************/
+
+/*!
+ * Axis-aligned bounding box.
+ */
+struct AABB {
+	Vec3 min;
+	Vec3 max;
+	
+	Vec3 getCenter() const {
+		return (min + max) * 0.5f;
+	}
+	
+	Vec3 getExtents() const {
+		return (max - min) * 0.5f;
+	}
+};
+
+/*!
+ * Returns the bounding box of a transformed box.
+ */
+AABB transformAABB(const Mat4& a, const AABB& box);
+
+/*!
+ * Axis-aligned rectangle (2D bounding box).
+ */
+struct Rect {
+	Vec2 min;
+	Vec2 max;
+	
+	Vec2 getCenter() const {
+		return (min + max) * 0.5f;
+	}
+	
+	Vec2 getSize() const {
+		return max - min;
+	}
+	
+	bool contains(const Vec2& p) const {
+		return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y;
+	}
+	
+	bool contains(const Rect& r) const {
+		return r.min.x >= min.x && r.max.x <= max.x && r.min.y >= min.y && r.max.y <= max.y;
+	}
+	
+	bool intersects(const Rect& r) const {
+		return r.min.x <= max.x && r.max.x >= min.x && r.min.y <= max.y && r.max.y >= min.y;
+	}
+};
+
+/*!
+ * Intersects the ray origin + t * direction (0 <= t <= maxT) with a
+ * rectangle. On a hit, returns true and stores the entry distance in t (0
+ * if the origin is inside).
+ */
+bool intersectRay(const Rect& rect, const Vec2& origin, const Vec2& direction, float maxT, float& t);
+
+
+/*******************************************************************
+ * Batch operations
+ *******************************************************************/
+
+/*!
+ * Transforms count points (w = 1) by one matrix. in and out may be the
+ * same array.
+ */
+void transformPoints(const Mat4& a, const Vec3* in, Vec3* out, std::size_t count);
+
+/*!
+ * Transforms count vectors by one matrix. in and out may be the same array.
+ */
+void transformVectors(const Mat4& a, const Vec4* in, Vec4* out, std::size_t count);
+
+/*!
+ * Computes out[i] = a * b[i] for count matrices.
+ */
+void multiplyMatrices(const Mat4& a, const Mat4* b, Mat4* out, std::size_t count);
+
+/*!
+ * Computes out[i] = a[i] * b[i] for count matrices.
+ */
+void multiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, std::size_t count);
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_MATH_H */
@@ -0,0 +1,128 @@
+#include "MemoryStats.h"
+
+#include <atomic>
+#include <iomanip>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Internal counters
+ *******************************************************************/
+
+namespace {
+	struct TagCounters {
+		std::atomic<std::size_t> liveBytes {0};
+		std::atomic<std::size_t> peakBytes {0};
+		std::atomic<std::size_t> liveCount {0};
+		std::atomic<std::size_t> totalCount {0};
+		
+		// Allocations in the current frame and in the last completed one
+		std::atomic<std::size_t> frameCount {0};
+		std::atomic<std::size_t> frameBytes {0};
+		std::atomic<std::size_t> lastFrameCount {0};
+		std::atomic<std::size_t> lastFrameBytes {0};
+	};
+	
+	const std::size_t tagCount = static_cast<std::size_t>(MemoryTag::Count);
+	
+	TagCounters& getCounters(MemoryTag tag) {
+		static TagCounters counters[tagCount];
+		return counters[static_cast<std::size_t>(tag)];
+	}
+	
+	// Prints a byte count with a binary unit
+	void printBytes(std::ostream& out, std::size_t bytes) {
+		if (bytes >= 1024 * 1024) {
+			out << std::setw(8) << (bytes / (1024.0 * 1024.0)) << " MiB";
+		}
+		else {
+			out << std::setw(8) << (bytes / 1024.0) << " KiB";
+		}
+	}
+}
+
+
+/*******************************************************************
+ * Allocation tracking
+ *******************************************************************/
+
+void trackAllocation(MemoryTag tag, std::size_t bytes) {
+	TagCounters& counters = getCounters(tag);
+	
+	std::size_t liveBytes = counters.liveBytes.fetch_add(bytes) + bytes;
+	counters.liveCount++;
+	counters.totalCount++;
+	counters.frameCount++;
+	counters.frameBytes += bytes;
+	
+	// Raise peak if this allocation exceeded it
+	std::size_t peakBytes = counters.peakBytes.load();
+	while (liveBytes > peakBytes && !counters.peakBytes.compare_exchange_weak(peakBytes, liveBytes)) {
+	}
+}
+
+void trackDeallocation(MemoryTag tag, std::size_t bytes) {
+	TagCounters& counters = getCounters(tag);
+	counters.liveBytes -= bytes;
+	counters.liveCount--;
+}
+
+MemoryTagStats getMemoryStats(MemoryTag tag) {
+	TagCounters& counters = getCounters(tag);
+	
+	MemoryTagStats stats;
+	stats.liveBytes = counters.liveBytes;
+	stats.peakBytes = counters.peakBytes;
+	stats.liveCount = counters.liveCount;
+	stats.totalCount = counters.totalCount;
+	stats.lastFrameCount = counters.lastFrameCount;
+	stats.lastFrameBytes = counters.lastFrameBytes;
+	return stats;
+}
+
+const char* getMemoryTagName(MemoryTag tag) {
+	switch (tag) {
+	case MemoryTag::Image:      return "Image";
+	case MemoryTag::Shader:     return "Shader";
+	case MemoryTag::Jobs:       return "Jobs";
+	case MemoryTag::Frame:      return "Frame";
+	case MemoryTag::Entities:   return "Entities";
+	case MemoryTag::Particles:  return "Particles";
+	case MemoryTag::Renderer:   return "Renderer";
+	case MemoryTag::TextureGPU: return "Texture (GPU)";
+	case MemoryTag::BufferGPU:  return "Buffer (GPU)";
+	default:                    return "Unknown";
+	}
+}
+
+void endMemoryStatsFrame() {
+	for (std::size_t i = 0; i < tagCount; ++i) {
+		TagCounters& counters = getCounters(static_cast<MemoryTag>(i));
+		counters.lastFrameCount = counters.frameCount.exchange(0);
+		counters.lastFrameBytes = counters.frameBytes.exchange(0);
+	}
+}
+
+void printMemoryStats(std::ostream& out) {
+	std::ios::fmtflags flags = out.flags();
+	out << std::fixed << std::setprecision(2);
+	
+	out << "Memory statistics:" << std::endl;
+	out << "  Tag                    Live          Peak   Objects   Allocs/frame" << std::endl;
+	
+	for (std::size_t i = 0; i < tagCount; ++i) {
+		MemoryTag tag = static_cast<MemoryTag>(i);
+		MemoryTagStats stats = getMemoryStats(tag);
+		
+		out << "  " << std::left << std::setw(14) << getMemoryTagName(tag) << std::right;
+		printBytes(out, stats.liveBytes);
+		out << "  ";
+		printBytes(out, stats.peakBytes);
+		out << std::setw(10) << stats.liveCount
+		    << std::setw(15) << stats.lastFrameCount << std::endl;
+	}
+	
+	out.flags(flags);
+}
+
+} // end namespace bdEngine
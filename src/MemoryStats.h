@@ -0,0 +1,115 @@
+#ifndef _BDENGINE_MEMORYSTATS_H
+#define _BDENGINE_MEMORYSTATS_H
+
+#include <cstddef>
+#include <new>
+#include <ostream>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Allocation tracking per subsystem
+ *******************************************************************/
+
+/*!
+ * Subsystems that memory usage is recorded for. GPU tags hold estimates of
+ * video memory, not actual allocations.
+ */
+enum class MemoryTag {
+	Image,        // decoded image pixels and mip chains (see ImageAllocator)
+	Shader,       // shader sources
+	Jobs,         // job queue
+	Frame,        // per-frame arena buffers
+	Entities,     // entity component chunks
+	Particles,    // particle arrays
+	Renderer,     // CPU side vertex, index and batch data of the renderer
+	TextureGPU,   // texture objects (estimate)
+	BufferGPU,    // vertex and index buffers (estimate)
+	Count
+};
+
+/*!
+ * Counters of one tag.
+ */
+struct MemoryTagStats {
+	std::size_t liveBytes = 0;
+	std::size_t peakBytes = 0;
+	std::size_t liveCount = 0;
+	std::size_t totalCount = 0;
+	
+	// Allocations made during the last completed frame
+	std::size_t lastFrameCount = 0;
+	std::size_t lastFrameBytes = 0;
+};
+
+/*!
+ * Records an allocation or a deallocation of bytes for a tag. Thread-safe.
+ */
+void trackAllocation(MemoryTag tag, std::size_t bytes);
+void trackDeallocation(MemoryTag tag, std::size_t bytes);
+
+/*!
+ * Returns a snapshot of the counters of a tag.
+ */
+MemoryTagStats getMemoryStats(MemoryTag tag);
+
+/*!
+ * Returns a human readable name of a tag.
+ */
+const char* getMemoryTagName(MemoryTag tag);
+
+/*!
+ * Completes the per-frame allocation counters. Has to be called once at the
+ * end of every frame.
+ */
+void endMemoryStatsFrame();
+
+/*!
+ * Writes a table of all counters.
+ */
+void printMemoryStats(std::ostream& out);
+
+
+/*!
+ * Standard library allocator that records its allocations for a tag.
+ */
+template <class T, MemoryTag tag>
+class TrackingAllocator {
+public:
+	using value_type = T;
+	
+	template <class U>
+	struct rebind {
+		using other = TrackingAllocator<U, tag>;
+	};
+	
+	TrackingAllocator() {}
+	
+	template <class U>
+	TrackingAllocator(const TrackingAllocator<U, tag>& other) {}
+	
+	T* allocate(std::size_t n) {
+		T* ptr = static_cast<T*>(::operator new(n * sizeof(T)));
+		trackAllocation(tag, n * sizeof(T));
+		return ptr;
+	}
+	
+	void deallocate(T* ptr, std::size_t n) {
+		::operator delete(ptr);
+		trackDeallocation(tag, n * sizeof(T));
+	}
+};
+
+template <class T, class U, MemoryTag tag>
+bool operator==(const TrackingAllocator<T, tag>& a, const TrackingAllocator<U, tag>& b) {
+	return true;
+}
+
+template <class T, class U, MemoryTag tag>
+bool operator!=(const TrackingAllocator<T, tag>& a, const TrackingAllocator<U, tag>& b) {
+	return false;
+}
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_MEMORYSTATS_H */
@@ -0,0 +1,222 @@
+#include "MipChain.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Filters and color space conversion
+ *******************************************************************/
+
+namespace {
+	// Separable downsampling filter: destination pixel i is the weighted sum
+	// of the source pixels 2*i + offset + k (k = 0..taps-1).
+	struct FilterKernel {
+		int offset;
+		std::vector<float> weights;
+	};
+	
+	// Zeroth order modified Bessel function of the first kind (for the Kaiser window)
+	float besselI0(float x) {
+		float sum = 1.0f;
+		float term = 1.0f;
+		for (int k = 1; k < 16; ++k) {
+			term *= (x / (2.0f * k)) * (x / (2.0f * k));
+			sum += term;
+		}
+		return sum;
+	}
+	
+	FilterKernel makeKernel(MipFilter filter) {
+		if (filter == MipFilter::Box) {
+			return FilterKernel {0, {0.5f, 0.5f}};
+		}
+		
+		// Kaiser windowed sinc with a half width of 2 destination pixels
+		const float pi = 3.14159265358979f;
+		const float alpha = 4.0f;
+		const float halfWidth = 2.0f;
+		
+		FilterKernel kernel {-3, std::vector<float>(8)};
+		float sum = 0.0f;
+		for (int k = 0; k < 8; ++k) {
+			// Distance between source and destination pixel center, in destination pixels
+			float d = (k - 3.5f) / 2.0f;
+			float sinc = std::sin(pi * d) / (pi * d);
+			float r = d / halfWidth;
+			float window = besselI0(alpha * std::sqrt(std::max(0.0f, 1.0f - r * r))) / besselI0(alpha);
+			kernel.weights[k] = sinc * window;
+			sum += kernel.weights[k];
+		}
+		for (auto& w : kernel.weights) {
+			w /= sum;
+		}
+		return kernel;
+	}
+	
+	// sRGB -> linear lookup table for all 8 bit values
+	struct SRGBToLinearTable {
+		float values[256];
+		
+		SRGBToLinearTable() {
+			for (int i = 0; i < 256; ++i) {
+				float c = i / 255.0f;
+				values[i] = (c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f));
+			}
+		}
+	};
+	
+	// linear -> sRGB lookup table, indexed with 16 bit precision
+	struct LinearToSRGBTable {
+		static const int size = 65536;
+		unsigned char values[size];
+		
+		LinearToSRGBTable() {
+			for (int i = 0; i < size; ++i) {
+				float c = static_cast<float>(i) / (size - 1);
+				float s = (c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f);
+				values[i] = static_cast<unsigned char>(s * 255.0f + 0.5f);
+			}
+		}
+	};
+	
+	const SRGBToLinearTable srgbToLinear;
+	const LinearToSRGBTable linearToSRGB;
+	
+	// Alpha is stored linearly, every other channel is sRGB encoded.
+	inline bool isAlphaChannel(std::size_t index, int channels) {
+		return channels == 4 && (index & 3) == 3;
+	}
+	
+	inline unsigned char encodeChannel(float value, bool alpha) {
+		value = std::min(std::max(value, 0.0f), 1.0f);
+		if (alpha) {
+			return static_cast<unsigned char>(value * 255.0f + 0.5f);
+		}
+		return linearToSRGB.values[static_cast<int>(value * (LinearToSRGBTable::size - 1) + 0.5f)];
+	}
+	
+	// dst[i] = sum of weights[k] * rows[k][i], for i in [0, count)
+	void weightedRowSum(float* dst, const float* const* rows, const float* weights,
+		std::size_t taps, std::size_t count)
+	{
+		std::size_t i = 0;
+
+#ifdef __SSE__
+		for (; i + 4 <= count; i += 4) {
+			__m128 acc = _mm_mul_ps(_mm_set1_ps(weights[0]), _mm_loadu_ps(rows[0] + i));
+			for (std::size_t k = 1; k < taps; ++k) {
+				acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(rows[k] + i)));
+			}
+			_mm_storeu_ps(dst + i, acc);
+		}
+#endif
+
+		for (; i < count; ++i) {
+			float acc = 0.0f;
+			for (std::size_t k = 0; k < taps; ++k) {
+				acc += weights[k] * rows[k][i];
+			}
+			dst[i] = acc;
+		}
+	}
+}
+
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+MipChain::MipChain(const Image& srcImage, MipFilter filter, JobSystem* jobSystem, ImageAllocator& allocator)
+	: channels {srcImage.getChannels()}
+{
+	if (srcImage.getData() == nullptr) {
+		throw std::invalid_argument("Cannot generate mip chain of an empty image.");
+	}
+	
+	const FilterKernel kernel = makeKernel(filter);
+	const std::size_t taps = kernel.weights.size();
+	
+	// Level 0 is the image itself
+	Level base {allocator};
+	base.width = srcImage.getWidth();
+	base.height = srcImage.getHeight();
+	base.data.assign(srcImage.getData(),
+		srcImage.getData() + static_cast<std::size_t>(base.width) * base.height * channels);
+	
+	// Linear color values of the previous level (we filter from those instead
+	// of the quantized sRGB bytes to not accumulate rounding errors)
+	ImageVector<float> srcLinear (base.data.size(), 0.0f, allocator);
+	for (std::size_t i = 0; i < srcLinear.size(); ++i) {
+		srcLinear[i] = (isAlphaChannel(i, channels) ? base.data[i] / 255.0f : srgbToLinear.values[base.data[i]]);
+	}
+	
+	levels.push_back(std::move(base));
+	
+	while (levels.back().width > 1 || levels.back().height > 1) {
+		const int srcWidth = levels.back().width;
+		const int srcHeight = levels.back().height;
+		const std::size_t srcRowSize = static_cast<std::size_t>(srcWidth) * channels;
+		
+		Level level {allocator};
+		level.width = std::max(srcWidth / 2, 1);
+		level.height = std::max(srcHeight / 2, 1);
+		const std::size_t dstRowSize = static_cast<std::size_t>(level.width) * channels;
+		level.data.resize(dstRowSize * level.height);
+		ImageVector<float> dstLinear (level.data.size(), 0.0f, allocator);
+		
+		// Filters the destination rows [rowBegin, rowEnd): first vertically
+		// into a temporary row (SIMD), then horizontally.
+		auto filterRows = [&](std::size_t rowBegin, std::size_t rowEnd) {
+			ImageVector<float> tmpRow (srcRowSize, 0.0f, allocator);
+			std::vector<const float*> srcRows (taps);
+			
+			for (std::size_t y = rowBegin; y < rowEnd; ++y) {
+				for (std::size_t k = 0; k < taps; ++k) {
+					int srcY = std::min(std::max(2 * static_cast<int>(y) + kernel.offset + static_cast<int>(k), 0), srcHeight - 1);
+					srcRows[k] = &srcLinear[srcY * srcRowSize];
+				}
+				weightedRowSum(tmpRow.data(), srcRows.data(), kernel.weights.data(), taps, srcRowSize);
+				
+				float* dstRow = &dstLinear[y * dstRowSize];
+				unsigned char* dstBytes = &level.data[y * dstRowSize];
+				
+				for (int x = 0; x < level.width; ++x) {
+					for (int c = 0; c < channels; ++c) {
+						float acc = 0.0f;
+						for (std::size_t k = 0; k < taps; ++k) {
+							int srcX = std::min(std::max(2 * x + kernel.offset + static_cast<int>(k), 0), srcWidth - 1);
+							acc += kernel.weights[k] * tmpRow[srcX * channels + c];
+						}
+						
+						std::size_t i = static_cast<std::size_t>(x) * channels + c;
+						dstRow[i] = acc;
+						dstBytes[i] = encodeChannel(acc, isAlphaChannel(i, channels));
+					}
+				}
+			}
+		};
+		
+		if (jobSystem != nullptr) {
+			// Aim for roughly 16k destination pixels per job
+			std::size_t grainSize = std::max<std::size_t>(16384 / level.width, 1);
+			jobSystem->parallelFor(level.height, grainSize, filterRows);
+		}
+		else {
+			filterRows(0, level.height);
+		}
+		
+		srcLinear = std::move(dstLinear);
+		levels.push_back(std::move(level));
+	}
+}
+
+} // end namespace bdEngine
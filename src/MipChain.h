@@ -0,0 +1,102 @@
+#ifndef _BDENGINE_MIPCHAIN_H
+#define _BDENGINE_MIPCHAIN_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Image.h"
+#include "ImageAllocator.h"
+
+namespace bdEngine {
+
+class JobSystem;
+
+/*!
+ * Downsampling filter used to generate mip levels.
+ */
+enum class MipFilter {
+	Box,     // 2x2 average, fast
+	Kaiser,  // 8 tap Kaiser windowed sinc, sharper result
+};
+
+/*!
+ * Complete chain of mip levels of an image, generated on the CPU.
+ *
+ * Filtering is done in linear color space (color channels are treated as
+ * sRGB encoded, alpha as linear), so mip levels don't get darker than the
+ * base level. Generation can be spread over a JobSystem and doesn't need a GL
+ * context, so it can happen on worker threads or offline. The result is
+ * uploaded level by level by Texture2D.
+ *
+ * The pixel data of the levels and the intermediate buffers used while
+ * filtering are taken from an ImageAllocator, so chains that are built and
+ * released over and over again (e.g. by TextureManager) can recycle them.
+ */
+class MipChain {
+public:
+	/*!
+	 * One level of the chain with tightly packed pixel data.
+	 */
+	struct Level {
+		explicit Level(ImageAllocator& allocator = ImageAllocator::getDefault())
+			: data (allocator)
+		{}
+		
+		int width = 0;
+		int height = 0;
+		ImageVector<unsigned char> data;
+	};
+	
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Default constructor. Creates an empty chain without any levels.
+	 */
+	MipChain() {}
+	
+	/*!
+	 * Generates the full mip chain (down to 1x1) of an image. Level 0 is a
+	 * copy of the image itself. If jobSystem is given, the rows of each
+	 * level are filtered in parallel. All buffers are taken from allocator,
+	 * which has to outlive the chain.
+	 */
+	MipChain(const Image& srcImage, MipFilter filter = MipFilter::Box,
+		JobSystem* jobSystem = nullptr, ImageAllocator& allocator = ImageAllocator::getDefault());
+	
+	
+	/*******************************************************************
+	 * Properties
+	 *******************************************************************/
+	/*!
+	 * Returns the number of levels (0 for an empty chain).
+	 */
+	std::size_t getLevelCount() const {
+		return levels.size();
+	}
+	
+	/*!
+	 * Returns a level, 0 being the full resolution image.
+	 */
+	const Level& getLevel(std::size_t level) const {
+		return levels[level];
+	}
+	
+	/*!
+	 * Returns the number of color channels per pixel.
+	 */
+	int getChannels() const {
+		return channels;
+	}
+
+private:
+	// Mip levels, largest first
+	std::vector<Level> levels;
+	
+	// Number of color channels per pixel
+	int channels = 0;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_MIPCHAIN_H */
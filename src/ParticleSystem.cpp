@@ -0,0 +1,271 @@
+#include "ParticleSystem.h"
+#include "FrameUniforms.h"
+#include "RenderStats.h"
+
+#include <algorithm>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Constants, shader sources
+ *******************************************************************/
+
+// Vertex shader source code (after FrameUniforms::glslBlock)
+static const GLchar* particleVertexShaderSrc = R"__SRC__(
+
+layout (location = 0) in vec2 corner;
+layout (location = 1) in vec3 particle;  // position xy, size
+layout (location = 2) in vec4 color;
+
+out vec2 fragCoord;
+out vec4 fragColor;
+
+void main() {
+	gl_Position = viewProjection * vec4(particle.xy + corner * particle.z, 0.0, 1.0);
+	fragCoord = corner * 2.0;
+	fragColor = color;
+}
+
+)__SRC__";
+
+// Fragment shader source code (shared by all backends)
+const GLchar* const ParticleSystem::fragShaderSrc = R"__SRC__(
+#version 330 core
+
+in vec2 fragCoord;
+in vec4 fragColor;
+out vec4 color;
+
+void main() {
+	// Round particle with a soft edge
+	float alpha = 1.0 - smoothstep(0.6, 1.0, length(fragCoord));
+	color = vec4(fragColor.rgb, fragColor.a * alpha);
+}
+
+)__SRC__";
+
+// Corners of a unit quad around the particle (triangle strip)
+const GLfloat ParticleSystem::quadCorners[8] = {
+	-0.5f, -0.5f,
+	 0.5f, -0.5f,
+	-0.5f,  0.5f,
+	 0.5f,  0.5f,
+};
+
+const float ParticleSystem::fadeOutTime = 0.25f;
+
+// Particles per task of the job system
+static const std::size_t particleGrainSize = 16384;
+
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+CPUParticleSystem::CPUParticleSystem(JobSystem& jobSystem, std::size_t maxParticles)
+	: ParticleSystem(maxParticles)
+	, jobSystem_ (jobSystem)
+	, positionX_ (maxParticles)
+	, positionY_ (maxParticles)
+	, velocityX_ (maxParticles)
+	, velocityY_ (maxParticles)
+	, life_ (maxParticles)
+	, size_ (maxParticles)
+	, color_ (maxParticles)
+{
+	// -- Compile and link shader program
+	const GLchar* vertexShaderSrcs[] = {FrameUniforms::glslBlock, particleVertexShaderSrc};
+	shaderProgram_.addShader(vertexShaderSrcs, GL_VERTEX_SHADER, 2);
+	shaderProgram_.addShader(&fragShaderSrc, GL_FRAGMENT_SHADER);
+	shaderProgram_.linkShaders();
+	shaderProgram_.bindUniformBlock(FrameUniforms::blockName, FrameUniforms::bindingPoint);
+	
+	glGenVertexArrays(1, &vao_);
+	glGenBuffers(1, &quadVBO_);
+	glGenBuffers(1, &instanceVBO_);
+	
+	glBindVertexArray(vao_);
+	
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO_);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quadCorners), quadCorners, GL_STATIC_DRAW);
+	// -> location 0: corner
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (GLvoid*)0);
+	glEnableVertexAttribArray(0);
+	
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
+	glBufferData(GL_ARRAY_BUFFER, maxParticles * sizeof(Instance), nullptr, GL_STREAM_DRAW);
+	// -> location 1: particle position and size (per instance)
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), (GLvoid*)offsetof(Instance, x));
+	glEnableVertexAttribArray(1);
+	glVertexAttribDivisor(1, 1);
+	// -> location 2: color (per instance)
+	glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Instance), (GLvoid*)offsetof(Instance, color));
+	glEnableVertexAttribArray(2);
+	glVertexAttribDivisor(2, 1);
+	
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	
+	bufferBytes_ = sizeof(quadCorners) + maxParticles * sizeof(Instance);
+	trackAllocation(MemoryTag::BufferGPU, bufferBytes_);
+}
+
+// Destructor
+CPUParticleSystem::~CPUParticleSystem() {
+	glDeleteVertexArrays(1, &vao_);
+	glDeleteBuffers(1, &quadVBO_);
+	glDeleteBuffers(1, &instanceVBO_);
+	trackDeallocation(MemoryTag::BufferGPU, bufferBytes_);
+}
+
+
+/*******************************************************************
+ * Simulation
+ *******************************************************************/
+
+bool CPUParticleSystem::spawn(const ParticleSpawn& particle) {
+	if (count_ == maxParticles_) {
+		return false;
+	}
+	
+	std::size_t i = count_++;
+	positionX_[i] = particle.position.x;
+	positionY_[i] = particle.position.y;
+	velocityX_[i] = particle.velocity.x;
+	velocityY_[i] = particle.velocity.y;
+	life_[i] = particle.life;
+	size_[i] = particle.size;
+	color_[i] = particle.color;
+	return true;
+}
+
+void CPUParticleSystem::update(float dt) {
+	// -- Integrate
+	if (count_ > particleGrainSize) {
+		jobSystem_.parallelFor(count_, particleGrainSize, [this, dt](std::size_t begin, std::size_t end) {
+			integrateRange(begin, end, dt);
+		});
+	}
+	else {
+		integrateRange(0, count_, dt);
+	}
+	
+	// -- Remove dead particles by moving the last one into their place
+	std::size_t i = 0;
+	while (i < count_) {
+		if (life_[i] > 0.0f) {
+			++i;
+			continue;
+		}
+		
+		std::size_t last = --count_;
+		positionX_[i] = positionX_[last];
+		positionY_[i] = positionY_[last];
+		velocityX_[i] = velocityX_[last];
+		velocityY_[i] = velocityY_[last];
+		life_[i] = life_[last];
+		size_[i] = size_[last];
+		color_[i] = color_[last];
+	}
+}
+
+void CPUParticleSystem::clear() {
+	count_ = 0;
+}
+
+
+/*******************************************************************
+ * Drawing
+ *******************************************************************/
+
+void CPUParticleSystem::draw() {
+	if (count_ == 0) {
+		return;
+	}
+	
+	// Fill the instance buffer in place (invalidating it, so that the
+	// driver doesn't wait for the previous frame's draw)
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
+	Instance* instances = static_cast<Instance*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, count_ * sizeof(Instance),
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+	if (instances == nullptr) {
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		return;
+	}
+	
+	if (count_ > particleGrainSize) {
+		jobSystem_.parallelFor(count_, particleGrainSize, [this, instances](std::size_t begin, std::size_t end) {
+			writeInstances(instances, begin, end);
+		});
+	}
+	else {
+		writeInstances(instances, 0, count_);
+	}
+	
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	countUpload(count_, count_ * sizeof(Instance));
+	
+	shaderProgram_.useProgram();
+	glBindVertexArray(vao_);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(count_));
+	countDrawCall(count_ * 2);
+	glBindVertexArray(0);
+}
+
+
+/*******************************************************************
+ * Internal helpers
+ *******************************************************************/
+
+void CPUParticleSystem::integrateRange(std::size_t begin, std::size_t end, float dt) {
+	float* px = positionX_.data();
+	float* py = positionY_.data();
+	float* vx = velocityX_.data();
+	float* vy = velocityY_.data();
+	float* life = life_.data();
+	std::size_t i = begin;
+
+#ifdef __SSE__
+	// Four particles at a time (semi-implicit Euler)
+	const __m128 dtv = _mm_set1_ps(dt);
+	const __m128 gx = _mm_set1_ps(gravity_.x * dt);
+	const __m128 gy = _mm_set1_ps(gravity_.y * dt);
+	
+	for (; i + 4 <= end; i += 4) {
+		__m128 velX = _mm_add_ps(_mm_loadu_ps(vx + i), gx);
+		__m128 velY = _mm_add_ps(_mm_loadu_ps(vy + i), gy);
+		_mm_storeu_ps(vx + i, velX);
+		_mm_storeu_ps(vy + i, velY);
+		_mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(velX, dtv)));
+		_mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(velY, dtv)));
+		_mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), dtv));
+	}
+#endif
+
+	for (; i < end; ++i) {
+		vx[i] += gravity_.x * dt;
+		vy[i] += gravity_.y * dt;
+		px[i] += vx[i] * dt;
+		py[i] += vy[i] * dt;
+		life[i] -= dt;
+	}
+}
+
+void CPUParticleSystem::writeInstances(Instance* instances, std::size_t begin, std::size_t end) const {
+	for (std::size_t i = begin; i < end; ++i) {
+		// Scale alpha down at the end of the particle's life
+		std::uint32_t color = color_[i];
+		float fade = std::min(life_[i] / fadeOutTime, 1.0f);
+		std::uint32_t alpha = static_cast<std::uint32_t>((color >> 24) * fade);
+		
+		Instance& instance = instances[i];
+		instance.x = positionX_[i];
+		instance.y = positionY_[i];
+		instance.size = size_[i];
+		instance.color = (color & 0x00FFFFFF) | (alpha << 24);
+	}
+}
+
+} // end namespace bdEngine
@@ -0,0 +1,195 @@
+#ifndef _BDENGINE_PARTICLESYSTEM_H
+#define _BDENGINE_PARTICLESYSTEM_H
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GLShaderProgram.h"
+#include "JobSystem.h"
+#include "Math.h"
+#include "MemoryStats.h"
+
+namespace bdEngine {
+
+/*!
+ * Initial state of a particle.
+ */
+struct ParticleSpawn {
+	Vec2 position;
+	Vec2 velocity;
+	float life = 1.0f;
+	float size = 0.05f;
+	
+	// Color (RGBA, 8 bits each, red in the lowest byte)
+	std::uint32_t color = 0xFFFFFFFF;
+};
+
+/*!
+ * Where a particle system simulates its particles.
+ */
+enum class ParticleBackend {
+	CPU,  // CPUParticleSystem
+	GPU,  // GPUParticleSystem
+};
+
+/*!
+ * Interface of 2D particle systems. The simulation backends differ in where
+ * the particles live: in CPU memory (CPUParticleSystem) or only in GPU
+ * buffers (GPUParticleSystem).
+ */
+class ParticleSystem {
+public:
+	virtual ~ParticleSystem() = default;
+	
+	// --- Forbid copy and move operations
+	ParticleSystem(const ParticleSystem& other)            = delete;  // copy constructor
+	ParticleSystem& operator=(const ParticleSystem& other) = delete;  // copy assignment
+	ParticleSystem(ParticleSystem&& other)                 = delete;  // move constructor
+	ParticleSystem& operator=(ParticleSystem&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Simulation
+	 *******************************************************************/
+	/*!
+	 * Adds a particle. Returns false if the system is full.
+	 */
+	virtual bool spawn(const ParticleSpawn& particle) = 0;
+	
+	/*!
+	 * Sets the acceleration applied to all particles.
+	 */
+	void setGravity(const Vec2& gravity) {
+		gravity_ = gravity;
+	}
+	
+	/*!
+	 * Advances all particles by dt seconds and removes dead ones.
+	 */
+	virtual void update(float dt) = 0;
+	
+	/*!
+	 * Removes all particles.
+	 */
+	virtual void clear() = 0;
+	
+	
+	/*******************************************************************
+	 * Drawing
+	 *******************************************************************/
+	/*!
+	 * Draws all particles (uses the FrameData uniform block).
+	 */
+	virtual void draw() = 0;
+	
+	
+	/*******************************************************************
+	 * Properties
+	 *******************************************************************/
+	/*!
+	 * Returns the number of particles (for GPU backends an upper bound).
+	 */
+	virtual std::size_t size() const = 0;
+	
+	std::size_t getCapacity() const {
+		return maxParticles_;
+	}
+
+protected:
+	explicit ParticleSystem(std::size_t maxParticles)
+		: maxParticles_ {maxParticles}
+	{}
+	
+	// Fragment shader drawing round particles with a soft edge (inputs:
+	// fragCoord in [-1, 1] and fragColor)
+	static const GLchar* const fragShaderSrc;
+	
+	// Corners of a unit quad around a particle (triangle strip, 2D)
+	static const GLfloat quadCorners[8];
+	
+	// Particles fade out during the last part of their life (in seconds)
+	static const float fadeOutTime;
+	
+	std::size_t maxParticles_;
+	Vec2 gravity_ {0.0f, 0.0f};
+};
+
+/*!
+ * 2D particles simulated on the CPU and drawn as instanced quads.
+ *
+ * Particles are stored as structure of arrays, so that update() can
+ * integrate four particles per SSE instruction, split across the job
+ * system for large counts. Dead particles are removed by moving the last
+ * particle into their place, which keeps the arrays packed. draw() writes
+ * the live particles directly into a mapped instance buffer and draws them
+ * with one call. Particles are round and fade out at the end of their life.
+ */
+class CPUParticleSystem final : public ParticleSystem {
+public:
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates an empty system for up to maxParticles particles.
+	 */
+	CPUParticleSystem(JobSystem& jobSystem, std::size_t maxParticles = 100000);
+	~CPUParticleSystem();
+	
+	
+	/*******************************************************************
+	 * ParticleSystem
+	 *******************************************************************/
+	bool spawn(const ParticleSpawn& particle) override;
+	void update(float dt) override;
+	void clear() override;
+	void draw() override;
+	
+	std::size_t size() const override {
+		return count_;
+	}
+
+private:
+	// Array of one particle attribute
+	template <class T>
+	using ParticleArray = std::vector<T, TrackingAllocator<T, MemoryTag::Particles>>;
+	
+	// Per-instance data in the vertex buffer
+	struct Instance {
+		float x, y;
+		float size;
+		std::uint32_t color;
+	};
+	
+	// Integrates particles [begin, end)
+	void integrateRange(std::size_t begin, std::size_t end, float dt);
+	
+	// Writes particles [begin, end) into the instance buffer
+	void writeInstances(Instance* instances, std::size_t begin, std::size_t end) const;
+	
+	// Worker threads for large systems
+	JobSystem& jobSystem_;
+	
+	// Particle data (structure of arrays, all of size maxParticles)
+	std::size_t count_ = 0;
+	ParticleArray<float> positionX_;
+	ParticleArray<float> positionY_;
+	ParticleArray<float> velocityX_;
+	ParticleArray<float> velocityY_;
+	ParticleArray<float> life_;
+	ParticleArray<float> size_;
+	ParticleArray<std::uint32_t> color_;
+	
+	// GL objects
+	GLShaderProgram shaderProgram_;
+	GLuint vao_ = 0;
+	GLuint quadVBO_ = 0;
+	GLuint instanceVBO_ = 0;
+	std::size_t bufferBytes_ = 0;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_PARTICLESYSTEM_H */
@@ -0,0 +1,272 @@
+#ifndef _BDENGINE_POOL_H
+#define _BDENGINE_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace bdEngine {
+
+/*!
+ * Generational handle to an object in a Pool.
+ *
+ * The 32 bit value consists of a 20 bit slot index and a 12 bit generation.
+ * The generation of a slot is incremented when its object is destroyed, so
+ * handles to destroyed objects are detected instead of silently referring to
+ * whatever object reuses the slot. The Tag parameter only serves to make
+ * handles of different pools distinct types.
+ */
+template <class Tag>
+struct PoolHandle {
+	static const std::uint32_t indexBits = 20;
+	static const std::uint32_t indexMask = (1u << indexBits) - 1;
+	static const std::uint32_t generationMask = 0xFFFFFFFFu >> indexBits;
+	static const std::uint32_t invalidValue = 0xFFFFFFFF;
+	
+	std::uint32_t value = invalidValue;
+	
+	PoolHandle() {}
+	
+	PoolHandle(std::uint32_t index, std::uint32_t generation)
+		: value {(generation & generationMask) << indexBits | (index & indexMask)}
+	{}
+	
+	std::uint32_t getIndex() const {
+		return value & indexMask;
+	}
+	
+	std::uint32_t getGeneration() const {
+		return value >> indexBits;
+	}
+	
+	bool isValid() const {
+		return value != invalidValue;
+	}
+	
+	bool operator==(const PoolHandle& other) const {
+		return value == other.value;
+	}
+	
+	bool operator!=(const PoolHandle& other) const {
+		return value != other.value;
+	}
+};
+
+
+/*!
+ * Fixed capacity object pool with generational handles.
+ *
+ * Objects are stored densely in one array, so iterating over all of them is a
+ * linear walk over contiguous memory. Handles refer to slots, which map to the
+ * current position of the object in the dense array; destroying an object
+ * moves the last object into its place. Looking up a handle is O(1) and
+ * returns nullptr for stale handles.
+ *
+ * Pointers and references to objects are invalidated by create() and
+ * destroy(), handles stay valid until their object is destroyed.
+ */
+template <class T, class Tag = T>
+class Pool {
+public:
+	using Handle = PoolHandle<Tag>;
+	
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates an empty pool for at most capacity objects. Storage for all of
+	 * them is reserved up front.
+	 */
+	explicit Pool(std::size_t capacity)
+		: capacity_ {capacity}
+	{
+		// The highest index would produce the invalid handle value
+		if (capacity > Handle::indexMask) {
+			throw std::invalid_argument("Pool capacity exceeds handle index range.");
+		}
+		
+		objects_.reserve(capacity);
+		denseToSlot_.reserve(capacity);
+		slots_.reserve(capacity);
+	}
+	
+	
+	/*******************************************************************
+	 * Objects
+	 *******************************************************************/
+	/*!
+	 * Constructs a new object and returns its handle.
+	 * Throws std::length_error if the pool is full.
+	 */
+	template <class... Args>
+	Handle create(Args&&... args) {
+		if (objects_.size() >= capacity_) {
+			throw std::length_error("Pool is full.");
+		}
+		
+		// Reuse a free slot or append a new one
+		std::uint32_t slotIndex;
+		if (freeSlot_ != noSlot) {
+			slotIndex = freeSlot_;
+			freeSlot_ = slots_[slotIndex].nextFree;
+		}
+		else {
+			slotIndex = static_cast<std::uint32_t>(slots_.size());
+			slots_.emplace_back();
+		}
+		
+		objects_.emplace_back(std::forward<Args>(args)...);
+		denseToSlot_.push_back(slotIndex);
+		
+		Slot& slot = slots_[slotIndex];
+		slot.denseIndex = static_cast<std::uint32_t>(objects_.size() - 1);
+		slot.nextFree = noSlot;
+		
+		return Handle {slotIndex, slot.generation};
+	}
+	
+	/*!
+	 * Destroys the object of a handle. Does nothing for stale handles.
+	 */
+	void destroy(Handle handle) {
+		if (!contains(handle)) {
+			return;
+		}
+		
+		std::uint32_t slotIndex = handle.getIndex();
+		Slot& slot = slots_[slotIndex];
+		
+		// Move last object into the gap
+		std::uint32_t lastIndex = static_cast<std::uint32_t>(objects_.size() - 1);
+		if (slot.denseIndex != lastIndex) {
+			objects_[slot.denseIndex] = std::move(objects_[lastIndex]);
+			denseToSlot_[slot.denseIndex] = denseToSlot_[lastIndex];
+			slots_[denseToSlot_[lastIndex]].denseIndex = slot.denseIndex;
+		}
+		objects_.pop_back();
+		denseToSlot_.pop_back();
+		
+		// Invalidate existing handles and put slot on the free list
+		slot.generation = (slot.generation + 1) & Handle::generationMask;
+		slot.denseIndex = noSlot;
+		slot.nextFree = freeSlot_;
+		freeSlot_ = slotIndex;
+	}
+	
+	/*!
+	 * Returns true if the handle refers to a live object.
+	 */
+	bool contains(Handle handle) const {
+		std::uint32_t slotIndex = handle.getIndex();
+		return handle.isValid() && slotIndex < slots_.size()
+			&& slots_[slotIndex].generation == handle.getGeneration()
+			&& slots_[slotIndex].denseIndex != noSlot;
+	}
+	
+	/*!
+	 * Returns the object of a handle, or nullptr if the handle is stale.
+	 */
+	T* get(Handle handle) {
+		return contains(handle) ? &objects_[slots_[handle.getIndex()].denseIndex] : nullptr;
+	}
+	
+	const T* get(Handle handle) const {
+		return contains(handle) ? &objects_[slots_[handle.getIndex()].denseIndex] : nullptr;
+	}
+	
+	/*!
+	 * Returns the handle of the object at a position in the dense array
+	 * (0 <= denseIndex < size()).
+	 */
+	Handle getHandle(std::size_t denseIndex) const {
+		std::uint32_t slotIndex = denseToSlot_[denseIndex];
+		return Handle {slotIndex, slots_[slotIndex].generation};
+	}
+	
+	/*!
+	 * Destroys all objects. All existing handles become stale.
+	 */
+	void clear() {
+		while (!objects_.empty()) {
+			destroy(getHandle(objects_.size() - 1));
+		}
+	}
+	
+	
+	/*******************************************************************
+	 * Iteration and properties
+	 *******************************************************************/
+	using iterator = typename std::vector<T>::iterator;
+	using const_iterator = typename std::vector<T>::const_iterator;
+	
+	iterator begin() {
+		return objects_.begin();
+	}
+	
+	iterator end() {
+		return objects_.end();
+	}
+	
+	const_iterator begin() const {
+		return objects_.begin();
+	}
+	
+	const_iterator end() const {
+		return objects_.end();
+	}
+	
+	/*!
+	 * Returns the object at a position in the dense array.
+	 */
+	T& operator[](std::size_t denseIndex) {
+		return objects_[denseIndex];
+	}
+	
+	const T& operator[](std::size_t denseIndex) const {
+		return objects_[denseIndex];
+	}
+	
+	/*!
+	 * Returns the number of live objects.
+	 */
+	std::size_t size() const {
+		return objects_.size();
+	}
+	
+	bool empty() const {
+		return objects_.empty();
+	}
+	
+	/*!
+	 * Returns the maximum number of objects.
+	 */
+	std::size_t getCapacity() const {
+		return capacity_;
+	}
+
+private:
+	static const std::uint32_t noSlot = 0xFFFFFFFF;
+	
+	// Indirection from handles to the dense array
+	struct Slot {
+		std::uint32_t denseIndex = noSlot;
+		std::uint32_t generation = 0;
+		std::uint32_t nextFree = noSlot;
+	};
+	
+	std::size_t capacity_;
+	
+	// Objects and the slot each of them belongs to
+	std::vector<T> objects_;
+	std::vector<std::uint32_t> denseToSlot_;
+	
+	// Slots by handle index, and the head of the free slot list
+	std::vector<Slot> slots_;
+	std::uint32_t freeSlot_ = noSlot;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_POOL_H */
@@ -0,0 +1,164 @@
+#include "QOI.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Format constants
+ *******************************************************************/
+
+namespace {
+	const unsigned char qoiMagic[4] = {'q', 'o', 'i', 'f'};
+	const std::size_t qoiHeaderSize = 14;
+	const std::size_t qoiPaddingSize = 8;  // end marker: 7x 0x00, 1x 0x01
+	
+	// Largest image we accept (same limit as the reference implementation)
+	const std::uint64_t qoiMaxPixels = 400000000;
+	
+	// Chunk tags
+	const unsigned char opIndex = 0x00;  // 00xxxxxx
+	const unsigned char opDiff  = 0x40;  // 01xxxxxx
+	const unsigned char opLuma  = 0x80;  // 10xxxxxx
+	const unsigned char opRun   = 0xc0;  // 11xxxxxx
+	const unsigned char opRGB   = 0xfe;  // 11111110
+	const unsigned char opRGBA  = 0xff;  // 11111111
+	const unsigned char opMask  = 0xc0;
+	
+	struct RGBA {
+		unsigned char r, g, b, a;
+	};
+	
+	inline std::uint32_t readBigEndian32(const unsigned char* p) {
+		return (std::uint32_t(p[0]) << 24) | (std::uint32_t(p[1]) << 16) | (std::uint32_t(p[2]) << 8) | p[3];
+	}
+	
+	inline unsigned int colorHash(const RGBA& px) {
+		return (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+	}
+}
+
+
+/*******************************************************************
+ * Decoding
+ *******************************************************************/
+
+bool isQOI(const unsigned char* data, std::size_t size) {
+	return data != nullptr && size >= sizeof(qoiMagic) && std::memcmp(data, qoiMagic, sizeof(qoiMagic)) == 0;
+}
+
+QOIHeader readQOIHeader(const unsigned char* data, std::size_t size) {
+	if (!isQOI(data, size) || size < qoiHeaderSize + qoiPaddingSize) {
+		throw std::runtime_error("Not a QOI image.");
+	}
+	
+	std::uint32_t width = readBigEndian32(data + 4);
+	std::uint32_t height = readBigEndian32(data + 8);
+	
+	QOIHeader header;
+	header.channels = data[12];
+	header.colorspace = data[13];
+	
+	if (width == 0 || height == 0 || std::uint64_t(width) * height > qoiMaxPixels
+		|| (header.channels != 3 && header.channels != 4) || header.colorspace > 1)
+	{
+		throw std::runtime_error("Invalid QOI header.");
+	}
+	
+	header.width = static_cast<int>(width);
+	header.height = static_cast<int>(height);
+	return header;
+}
+
+QOIHeader decodeQOI(const unsigned char* data, std::size_t size,
+	unsigned char* dst, std::size_t dstSize, int dstChannels)
+{
+	QOIHeader header = readQOIHeader(data, size);
+	
+	if (dstChannels != 3 && dstChannels != 4) {
+		throw std::invalid_argument("QOI can only be decoded to 3 or 4 channels.");
+	}
+	
+	const std::size_t dstLength = std::size_t(header.width) * header.height * dstChannels;
+	if (dst == nullptr || dstSize < dstLength) {
+		throw std::invalid_argument("QOI destination buffer too small.");
+	}
+	
+	RGBA index[64];
+	std::memset(index, 0, sizeof(index));
+	
+	RGBA px {0, 0, 0, 255};
+	unsigned int run = 0;
+	
+	const unsigned char* p = data + qoiHeaderSize;
+	const unsigned char* chunksEnd = data + size - qoiPaddingSize;
+	
+	for (std::size_t pos = 0; pos < dstLength; pos += dstChannels) {
+		if (run > 0) {
+			--run;
+		}
+		else if (p < chunksEnd) {
+			unsigned char b1 = *p++;
+			
+			if (b1 == opRGB) {
+				if (chunksEnd - p < 3) {
+					throw std::runtime_error("Truncated QOI data.");
+				}
+				px.r = p[0];
+				px.g = p[1];
+				px.b = p[2];
+				p += 3;
+			}
+			else if (b1 == opRGBA) {
+				if (chunksEnd - p < 4) {
+					throw std::runtime_error("Truncated QOI data.");
+				}
+				px.r = p[0];
+				px.g = p[1];
+				px.b = p[2];
+				px.a = p[3];
+				p += 4;
+			}
+			else if ((b1 & opMask) == opIndex) {
+				px = index[b1];
+			}
+			else if ((b1 & opMask) == opDiff) {
+				px.r += ((b1 >> 4) & 0x03) - 2;
+				px.g += ((b1 >> 2) & 0x03) - 2;
+				px.b += ( b1       & 0x03) - 2;
+			}
+			else if ((b1 & opMask) == opLuma) {
+				if (p >= chunksEnd) {
+					throw std::runtime_error("Truncated QOI data.");
+				}
+				unsigned char b2 = *p++;
+				int vg = (b1 & 0x3f) - 32;
+				px.r += vg - 8 + ((b2 >> 4) & 0x0f);
+				px.g += vg;
+				px.b += vg - 8 +  (b2       & 0x0f);
+			}
+			else if ((b1 & opMask) == opRun) {
+				run = (b1 & 0x3f);
+			}
+			
+			index[colorHash(px)] = px;
+		}
+		else {
+			// Data ended before all pixels were decoded
+			throw std::runtime_error("Truncated QOI data.");
+		}
+		
+		dst[pos + 0] = px.r;
+		dst[pos + 1] = px.g;
+		dst[pos + 2] = px.b;
+		if (dstChannels == 4) {
+			dst[pos + 3] = px.a;
+		}
+	}
+	
+	return header;
+}
+
+} // end namespace bdEngine
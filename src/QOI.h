@@ -0,0 +1,46 @@
+#ifndef _BDENGINE_QOI_H
+#define _BDENGINE_QOI_H
+
+#include <cstddef>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Decoder for the "Quite OK Image" format (https://qoiformat.org)
+ *******************************************************************/
+
+/*!
+ * Header of a QOI image.
+ */
+struct QOIHeader {
+	int width = 0;
+	int height = 0;
+	int channels = 0;    // 3 = RGB, 4 = RGBA
+	int colorspace = 0;  // 0 = sRGB with linear alpha, 1 = all linear
+};
+
+/*!
+ * Returns true if the data starts with the QOI magic bytes.
+ */
+bool isQOI(const unsigned char* data, std::size_t size);
+
+/*!
+ * Reads and validates the header of QOI encoded data.
+ * Throws std::runtime_error if the data is not a valid QOI image.
+ */
+QOIHeader readQOIHeader(const unsigned char* data, std::size_t size);
+
+/*!
+ * Decodes QOI encoded data into a caller provided buffer (e.g. a mapped pixel
+ * buffer object), without any intermediate allocations. Pixels are written
+ * tightly packed with dstChannels (3 or 4) channels each, dstSize has to be
+ * at least width * height * dstChannels bytes.
+ * Throws std::runtime_error on invalid data, and std::invalid_argument if
+ * dstChannels is not 3 or 4 or dst is too small.
+ */
+QOIHeader decodeQOI(const unsigned char* data, std::size_t size,
+	unsigned char* dst, std::size_t dstSize, int dstChannels);
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_QOI_H */
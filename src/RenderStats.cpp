@@ -0,0 +1,117 @@
+#include "RenderStats.h"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Internal counters
+ *******************************************************************/
+
+namespace {
+	// Counters of the current frame and a ring of completed frames
+	RenderStats current;
+	RenderStats history[renderStatsHistory];
+	std::size_t nextFrame = 0;
+	std::size_t completedFrames = 0;
+	
+	// Prints one counter of the last frame and its average
+	void printCounter(std::ostream& out, const char* name, std::size_t last, std::size_t sum, std::size_t frames) {
+		out << "  " << std::left << std::setw(18) << name << std::right
+		    << std::setw(10) << last
+		    << std::setw(14) << (frames > 0 ? static_cast<double>(sum) / frames : 0.0) << std::endl;
+	}
+}
+
+
+/*******************************************************************
+ * Counting
+ *******************************************************************/
+
+RenderStats& RenderStats::operator+=(const RenderStats& other) {
+	drawCalls += other.drawCalls;
+	triangles += other.triangles;
+	verticesUploaded += other.verticesUploaded;
+	bytesStreamed += other.bytesStreamed;
+	textureBinds += other.textureBinds;
+	programSwitches += other.programSwitches;
+	uniformUploads += other.uniformUploads;
+	frames += other.frames;
+	return *this;
+}
+
+void countDrawCall(std::size_t triangles) {
+	current.drawCalls++;
+	current.triangles += triangles;
+}
+
+void countUpload(std::size_t vertices, std::size_t bytes) {
+	current.verticesUploaded += vertices;
+	current.bytesStreamed += bytes;
+}
+
+void countTextureBind() {
+	current.textureBinds++;
+}
+
+void countProgramSwitch() {
+	current.programSwitches++;
+}
+
+void countUniformUpload(std::size_t count) {
+	current.uniformUploads += count;
+}
+
+
+/*******************************************************************
+ * Results
+ *******************************************************************/
+
+RenderStats getRenderStats() {
+	return accumulateRenderStats(1);
+}
+
+RenderStats accumulateRenderStats(std::size_t frames) {
+	frames = std::min(frames, completedFrames);
+	
+	// Walk back from the last completed frame
+	RenderStats sum;
+	for (std::size_t i = 1; i <= frames; ++i) {
+		sum += history[(nextFrame + renderStatsHistory - i) % renderStatsHistory];
+	}
+	return sum;
+}
+
+void endRenderStatsFrame() {
+	current.frames = 1;
+	history[nextFrame] = current;
+	nextFrame = (nextFrame + 1) % renderStatsHistory;
+	completedFrames = std::min(completedFrames + 1, renderStatsHistory);
+	current = RenderStats();
+}
+
+void printRenderStats(std::ostream& out, std::size_t frames) {
+	RenderStats last = getRenderStats();
+	RenderStats sum = accumulateRenderStats(frames);
+	
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+	out << std::fixed << std::setprecision(1);
+	
+	out << "Render statistics (average over " << sum.frames << " frames):" << std::endl;
+	out << "  " << std::left << std::setw(18) << "Counter" << std::right
+	    << std::setw(10) << "Last" << std::setw(14) << "Average" << std::endl;
+	printCounter(out, "Draw calls", last.drawCalls, sum.drawCalls, sum.frames);
+	printCounter(out, "Triangles", last.triangles, sum.triangles, sum.frames);
+	printCounter(out, "Vertices uploaded", last.verticesUploaded, sum.verticesUploaded, sum.frames);
+	printCounter(out, "Bytes streamed", last.bytesStreamed, sum.bytesStreamed, sum.frames);
+	printCounter(out, "Texture binds", last.textureBinds, sum.textureBinds, sum.frames);
+	printCounter(out, "Program switches", last.programSwitches, sum.programSwitches, sum.frames);
+	printCounter(out, "Uniform uploads", last.uniformUploads, sum.uniformUploads, sum.frames);
+	
+	out.flags(flags);
+	out.precision(precision);
+}
+
+} // end namespace bdEngine
@@ -0,0 +1,68 @@
+#ifndef _BDENGINE_RENDERSTATS_H
+#define _BDENGINE_RENDERSTATS_H
+
+#include <cstddef>
+#include <ostream>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Counters of the work submitted to OpenGL
+ *******************************************************************/
+
+/*!
+ * Counters of one or more frames.
+ */
+struct RenderStats {
+	std::size_t drawCalls = 0;
+	std::size_t triangles = 0;
+	std::size_t verticesUploaded = 0;
+	std::size_t bytesStreamed = 0;     // buffer data uploaded
+	std::size_t textureBinds = 0;
+	std::size_t programSwitches = 0;
+	std::size_t uniformUploads = 0;    // glUniform* calls and uniform buffer updates
+	
+	// Number of frames the counters were accumulated over
+	std::size_t frames = 0;
+	
+	RenderStats& operator+=(const RenderStats& other);
+};
+
+/*! Number of completed frames kept for accumulation. */
+const std::size_t renderStatsHistory = 120;
+
+/*!
+ * Record work of the current frame. Only to be called from the thread that
+ * owns the OpenGL context.
+ */
+void countDrawCall(std::size_t triangles);
+void countUpload(std::size_t vertices, std::size_t bytes);
+void countTextureBind();
+void countProgramSwitch();
+void countUniformUpload(std::size_t count = 1);
+
+/*!
+ * Returns the counters of the last completed frame.
+ */
+RenderStats getRenderStats();
+
+/*!
+ * Returns the sums of the counters over the last completed frames (up to
+ * renderStatsHistory, see RenderStats::frames for the actual number).
+ */
+RenderStats accumulateRenderStats(std::size_t frames);
+
+/*!
+ * Completes the counters of the current frame. Has to be called once at
+ * the end of every frame.
+ */
+void endRenderStatsFrame();
+
+/*!
+ * Writes the counters of the last frame and their averages over frames.
+ */
+void printRenderStats(std::ostream& out, std::size_t frames = renderStatsHistory);
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_RENDERSTATS_H */
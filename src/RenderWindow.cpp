@@ -1,5 +1,7 @@
 #include "RenderWindow.h"
+#include "MemoryStats.h"
 
+#include <algorithm>
 #include <functional>
 
 using namespace std::placeholders;
@@ -16,7 +18,8 @@ namespace bdEngine {
  * Construction and destruction
  *******************************************************************/
 
-RenderWindow::RenderWindow()
+RenderWindow::RenderWindow(JobSystem& jobSystem, FrameAllocator& frameAllocator, TransformSystem& transformSystem, World& world)
+	: inputListener_ {inputQueue_}
 {
 	// Initialize GLFW
 	GLFW::initLib();
@@ -39,21 +42,30 @@ RenderWindow::RenderWindow()
 		throw std::runtime_error("Failed to initialize GLEW.");
 	}
 	
-	// Set swap interval to >0 to avoid screen tearing
-	GLFW::setSwapInterval(1);
+	// Pace frames with VSync to avoid screen tearing (until told otherwise)
+	framePacer_ = std::make_unique<FramePacer>();
 	
-	// Set event callbacks
-	window_->setKeyCallback(std::bind(&RenderWindow::_test_key_callback, this, _1, _2, _3, _4, _5));
+	// Set input listener: record events for the game logic
+	window_->setListener(inputListener_);
+	
+	// XXX Bind the actions of the test application
+	testActions_.bind(TestAction::Quit, InputBinding::key(GLFW::KeyCode::Escape));
+	testActions_.bind(TestAction::Quit, InputBinding::key(GLFW::KeyCode::Q));
+	testActions_.bind(TestAction::ToggleWireframe, InputBinding::key(GLFW::KeyCode::F));
+	testActions_.bind(TestAction::PrintMemoryStats, InputBinding::key(GLFW::KeyCode::M));
+	testActions_.bind(TestAction::ToggleDebugOverlay, InputBinding::key(GLFW::KeyCode::F3));
 	
 	// Create Renderer instance
-	renderer_ = std::make_unique<Renderer>();
+	renderer_ = std::make_unique<Renderer>(jobSystem, frameAllocator, transformSystem, world);
 	
 	// Get framebuffer size and apply to renderer
 	GLFW::Size2D fbSize = window_->getFramebufferSize();
 	renderer_->setWindowSize(fbSize.width, fbSize.height);
 	
-	// Set callback for window resize event
-	window_->setWindowSizeCallback(std::bind(&Renderer::setWindowSize, renderer_.get(), _2, _3));
+	// Keep the viewport in sync with the framebuffer (in pixels, which
+	// differs from the window size on HiDPI displays). This is live window
+	// state, so it doesn't go through the input queue and isn't replayed.
+	window_->setFramebufferSizeCallback(std::bind(&Renderer::setWindowSize, renderer_.get(), _2, _3));
 }
 
 RenderWindow::~RenderWindow() {
@@ -70,55 +82,122 @@ void RenderWindow::stop() {
 	window_->setShouldClose(true);
 }
 
+/*! Wait until the next frame may start. */
+void RenderWindow::waitForFrame() {
+	framePacer_->waitForFrame();
+}
+
 /*! Draw one single frame, calling the Renderer and swapping buffers. */
-void RenderWindow::drawFrame() {
+void RenderWindow::drawFrame(float time) {
 	// Call Renderer to render frame
-	renderer_->drawFrame();
+	renderer_->drawFrame(time);
 	
 	// Swap buffers
 	window_->swapBuffers();
+	framePacer_->endFrame();
 }
 
-/*! Poll and handle events. */
+/*! Poll events. */
 void RenderWindow::handleEvents() {
-	// TODO Do the input thing (do we need to do more than pollEvents()?)
 	GLFW::pollEvents();
+	inputListener_.pollJoystick(GLFW::Joystick::Slot1);
 }
 
 
 /*******************************************************************
- * XXX Test functions
+ * Input recording
  *******************************************************************/
 
-void RenderWindow::_test_key_callback(GLFW::Window& window, GLFW::KeyCode key, int scancode,
-	GLFW::InputAction action, GLFW::KeyModifier mods)
+void RenderWindow::InputListener::onKey(GLFW::Window&, GLFW::KeyCode key, int scancode, GLFW::InputAction action,
+	GLFW::KeyModifier mods)
+{
+	queue.push(InputEvent {InputEventType::Key, static_cast<std::uint8_t>(action), static_cast<std::uint16_t>(mods),
+		static_cast<std::int32_t>(key), scancode, 0.0f, 0.0f, InputEvent::now()});
+}
+
+void RenderWindow::InputListener::onChar(GLFW::Window&, unsigned int codepoint) {
+	queue.push(InputEvent {InputEventType::Char, 0, 0, static_cast<std::int32_t>(codepoint), 0, 0.0f, 0.0f,
+		InputEvent::now()});
+}
+
+void RenderWindow::InputListener::onMouseButton(GLFW::Window&, GLFW::MouseButton button, GLFW::InputAction action,
+	GLFW::KeyModifier mods)
 {
-	const char* keyname = GLFW::getKeyName(key, scancode);
+	queue.push(InputEvent {InputEventType::MouseButton, static_cast<std::uint8_t>(action),
+		static_cast<std::uint16_t>(mods), static_cast<std::int32_t>(button), 0, 0.0f, 0.0f, InputEvent::now()});
+}
+
+void RenderWindow::InputListener::onCursorPos(GLFW::Window&, double x, double y) {
+	queue.push(InputEvent {InputEventType::CursorPos, 0, 0, 0, 0, static_cast<float>(x), static_cast<float>(y),
+		InputEvent::now()});
+}
+
+void RenderWindow::InputListener::onScroll(GLFW::Window&, double x, double y) {
+	queue.push(InputEvent {InputEventType::Scroll, 0, 0, 0, 0, static_cast<float>(x), static_cast<float>(y),
+		InputEvent::now()});
+}
+
+void RenderWindow::InputListener::onWindowSize(GLFW::Window&, int width, int height) {
+	queue.push(InputEvent {InputEventType::WindowSize, 0, 0, 0, 0, static_cast<float>(width),
+		static_cast<float>(height), InputEvent::now()});
+}
+
+void RenderWindow::InputListener::pollJoystick(GLFW::Joystick joystick) {
+	// A missing joystick has all buttons released and all axes centered
+	std::bitset<InputState::joystickButtonCount> buttons;
+	float axes[InputState::joystickAxisCount] = {};
+	if (GLFW::joystickPresent(joystick)) {
+		std::vector<GLFW::InputAction> buttonStates = GLFW::getJoystickButtons(joystick);
+		for (std::size_t i = 0; i < std::min(buttonStates.size(), buttons.size()); ++i) {
+			buttons[i] = buttonStates[i] == GLFW::InputAction::Press;
+		}
+		
+		std::vector<float> axisStates = GLFW::getJoystickAxes(joystick);
+		std::copy_n(axisStates.begin(), std::min(axisStates.size(), InputState::joystickAxisCount), axes);
+	}
 	
-	if (action == GLFW::InputAction::Press) {
-		switch (key) {
-		case GLFW::KeyCode::Escape:
-		case GLFW::KeyCode::Q:
-			window.setShouldClose(true);
-			break;
-			
-		case GLFW::KeyCode::F:
-			cout << "Wireframe mode: "
-			     << (renderer_->toggleWireframeMode() ? "on" : "off")
-			     << endl;
-			break;
-			
-		default:
-			cout << "Unbound key pressed: ";
-			if (keyname == nullptr) {
-				cout << scancode << endl;
-			}
-			else {
-				cout << "'" << keyname << "'" << endl;
-			}
-			break;
+	// Push the changes
+	std::uint64_t timestamp = InputEvent::now();
+	for (std::size_t i = 0; i < buttons.size(); ++i) {
+		if (buttons[i] != joystickButtons[i]) {
+			GLFW::InputAction action = buttons[i] ? GLFW::InputAction::Press : GLFW::InputAction::Release;
+			queue.push(InputEvent {InputEventType::JoystickButton, static_cast<std::uint8_t>(action), 0,
+				static_cast<std::int32_t>(i), 0, 0.0f, 0.0f, timestamp});
+		}
+	}
+	for (std::size_t i = 0; i < InputState::joystickAxisCount; ++i) {
+		if (axes[i] != joystickAxes[i]) {
+			queue.push(InputEvent {InputEventType::JoystickAxis, 0, 0, static_cast<std::int32_t>(i), 0, axes[i],
+				0.0f, timestamp});
+			joystickAxes[i] = axes[i];
 		}
 	}
+	joystickButtons = buttons;
+}
+
+
+/*******************************************************************
+ * XXX Test functions
+ *******************************************************************/
+
+void RenderWindow::_test_handle_input(const InputState& input) {
+	if (testActions_.wasPressed(input, TestAction::Quit)) {
+		stop();
+	}
+	
+	if (testActions_.wasPressed(input, TestAction::ToggleWireframe)) {
+		cout << "Wireframe mode: "
+		     << (renderer_->toggleWireframeMode() ? "on" : "off")
+		     << endl;
+	}
+	
+	if (testActions_.wasPressed(input, TestAction::PrintMemoryStats)) {
+		printMemoryStats(cout);
+	}
+	
+	if (testActions_.wasPressed(input, TestAction::ToggleDebugOverlay)) {
+		renderer_->toggleDebugOverlay();
+	}
 }
 
 
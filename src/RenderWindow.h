@@ -5,7 +5,14 @@
 #include <GL/glew.h>
 #include "GLFWpp.h"
 
+#include "FrameAllocator.h"
+#include "FramePacer.h"
+#include "InputQueue.h"
+#include "InputState.h"
+#include "JobSystem.h"
 #include "Renderer.h"
+#include "TransformSystem.h"
+#include "World.h"
 
 namespace bdEngine {
 
@@ -14,7 +21,7 @@ public:
 	/*******************************************************************
 	 * Construction and destruction
 	 *******************************************************************/
-	RenderWindow();
+	RenderWindow(JobSystem& jobSystem, FrameAllocator& frameAllocator, TransformSystem& transformSystem, World& world);
 	~RenderWindow();
 	
 	
@@ -37,13 +44,21 @@ public:
 	void stop();
 	
 	/*!
-	 * Draws one single frame. This will prepare drawing, call the Renderer
-	 * and finish drawing by swapping buffers.
+	 * Waits until the next frame may start (see FramePacer). Call before
+	 * handling events.
 	 */
-	void drawFrame();
+	void waitForFrame();
 	
 	/*!
-	 * Poll and handle events.
+	 * Draws one single frame at the given simulation time (in seconds).
+	 * This will prepare drawing, call the Renderer and finish drawing by
+	 * swapping buffers.
+	 */
+	void drawFrame(float time);
+	
+	/*!
+	 * Poll events (and the first joystick), which pushes them into the
+	 * input queue.
 	 */
 	void handleEvents();
 	
@@ -52,12 +67,33 @@ public:
 	 * Properties
 	 *******************************************************************/
 	
+	/*!
+	 * Returns the renderer drawing into this window.
+	 */
+	Renderer& getRenderer() {
+		return *renderer_;
+	}
+	
+	/*!
+	 * Returns the frame pacer of this window (VSync by default).
+	 */
+	FramePacer& getFramePacer() {
+		return *framePacer_;
+	}
+	
+	/*!
+	 * Returns the queue the window's input listener pushes events into
+	 * (during handleEvents()).
+	 */
+	InputQueue& getInputQueue() {
+		return inputQueue_;
+	}
+	
 	
 	/*******************************************************************
 	 * XXX Test functions
 	 *******************************************************************/
-	void _test_key_callback(GLFW::Window& window, GLFW::KeyCode key, int scancode,
-		GLFW::InputAction action, GLFW::KeyModifier mods);
+	void _test_handle_input(const InputState& input);
 
 private:
 	/*! The actual window instance. */
@@ -65,6 +101,45 @@ private:
 	
 	/*! Renderer instance. This is the actual graphics driver. */
 	std::unique_ptr<Renderer> renderer_;
+	
+	/*! Swap interval, frame rate and frames in flight control. */
+	std::unique_ptr<FramePacer> framePacer_;
+	
+	/*! Input events recorded by the listener. */
+	InputQueue inputQueue_;
+	
+	/*!
+	 * Window listener that records input and window size events into the
+	 * queue (bound at compile time, see GLFW::Window::setListener()).
+	 */
+	struct InputListener {
+		InputQueue& queue;
+		
+		void onKey(GLFW::Window& window, GLFW::KeyCode key, int scancode, GLFW::InputAction action,
+			GLFW::KeyModifier mods);
+		void onChar(GLFW::Window& window, unsigned int codepoint);
+		void onMouseButton(GLFW::Window& window, GLFW::MouseButton button, GLFW::InputAction action,
+			GLFW::KeyModifier mods);
+		void onCursorPos(GLFW::Window& window, double x, double y);
+		void onScroll(GLFW::Window& window, double x, double y);
+		void onWindowSize(GLFW::Window& window, int width, int height);
+		
+		// Pushes events for the joystick buttons and axes that changed
+		// since the last call
+		void pollJoystick(GLFW::Joystick joystick);
+		std::bitset<InputState::joystickButtonCount> joystickButtons;
+		float joystickAxes[InputState::joystickAxisCount] = {};
+	};
+	InputListener inputListener_;
+	
+	/*! XXX Actions of the test application and their bindings. */
+	enum class TestAction {
+		Quit,
+		ToggleWireframe,
+		PrintMemoryStats,
+		ToggleDebugOverlay,
+	};
+	ActionMap<TestAction> testActions_;
 };
 
 } // end namespace bdEngine
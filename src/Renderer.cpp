@@ -1,62 +1,43 @@
 #include "Renderer.h"
 
+#include <iomanip>
+#include <sstream>
+
 namespace bdEngine {
 
 /*******************************************************************
- * Constants, shader sources
+ * Constants
  *******************************************************************/
 
-// Vertex shader source code
-const GLchar* vertexShaderSrc = R"__SRC__(
-#version 330 core
-
-layout (location = 0) in vec3 position;
-layout (location = 1) in vec3 color;
-layout (location = 2) in vec2 texCoord;
-
-out vec3 fragColor;
-out vec2 fragTexCoord;
-
-void main() {
-	gl_Position = vec4(position.xyz, 1.0);
-	fragColor = color;
-	// Flip texture coordinates vertically because otherwise textures are upside down.
-	fragTexCoord = vec2(texCoord.x, 1 - texCoord.y);
-}
-
-)__SRC__";
+// Shader source files of the example object
+const char* exampleVertexShaderFile = "res/shaders/example.vert";
+const char* exampleFragmentShaderFile = "res/shaders/example.frag";
 
-// Fragment shader source code
-const GLchar* fragShaderSrc = R"__SRC__(
-#version 330 core
+// Default GPU memory budget for textures
+const std::size_t defaultTextureBudget = 256 * 1024 * 1024;
 
-in vec3 fragColor;
-in vec2 fragTexCoord;
-out vec4 color;
-
-uniform sampler2D texSampler1;
-uniform sampler2D texSampler2;
-
-void main() {
-	//color = vec4(0.9, 0.2, 0.6, 1);
-	color = mix(texture(texSampler1, fragTexCoord), texture(texSampler2, fragTexCoord), 0.5);
-}
-
-)__SRC__";
+// Frames the render statistics of the debug overlay are averaged over
+const std::size_t debugStatsFrames = 60;
 
 
 /*******************************************************************
  * Construction and destruction
  *******************************************************************/
 
-// Default constructor
-Renderer::Renderer()
+// Constructor
+Renderer::Renderer(JobSystem& jobSystem, FrameAllocator& frameAllocator, TransformSystem& transformSystem, World& world)
+	: jobSystem (jobSystem)
+	, frameAllocator (frameAllocator)
+	, transformSystem (transformSystem)
+	, world (world)
+	, spriteBatch {frameAllocator}
+	, overlayBatch {frameAllocator, 4096}
+	, lastFrameTime {std::chrono::steady_clock::now()}
+	, textureManager {jobSystem, defaultTextureBudget}
 {
-	// -- Compile and link shader program
-	shaderProgram.addShader(&vertexShaderSrc, GL_VERTEX_SHADER);
-	shaderProgram.addShader(&fragShaderSrc, GL_FRAGMENT_SHADER);
-	shaderProgram.linkShaders();
-	// shaderProgram.useProgram();
+	// -- Load shader program (compiled and linked once, shared through the cache)
+	shaderProgram = resourceCache.getShaderProgram(exampleVertexShaderFile, exampleFragmentShaderFile);
+	shaderProgram->bindUniformBlock(FrameUniforms::blockName, FrameUniforms::bindingPoint);
 	// TODO delete shaders after linking?
 	
 	
@@ -92,6 +73,9 @@ Renderer::Renderer()
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, exEBO);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 	
+	exBufferBytes = sizeof(vertices) + sizeof(indices);
+	trackAllocation(MemoryTag::BufferGPU, exBufferBytes);
+	
 	// Set vertex attributes pointers:
 	// -> location 0: position
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (GLvoid*)0);
@@ -106,19 +90,21 @@ Renderer::Renderer()
 	// Unbind VAO
 	glBindVertexArray(0);
 	
+	// Example object transformation (identity, the default camera shows
+	// [-1, 1] vertically)
+	exTransform = transformSystem.create();
+	
 	
 	// -- Load/create textures
-	// TODO Error handling with exceptions
+	// (Textures are loaded in the background and appear once they are resident.)
 	
-	// Load image data and create example texture 1
-	// Image img {"res/textures/bg_honk.png"};
-	Image img {"res/textures/bg_clouds.png"};
-	exTexture1 = Texture2D {img};
+	// Example texture 1
+	// exTexture1 = textureManager.load("res/textures/bg_honk.png");
+	exTexture1 = textureManager.load("res/textures/bg_clouds.png");
 	
-	// Load image data and create example texture 2
-	// img = Image {"res/textures/gamzee.png"};
-	img = Image {"res/textures/john.png"};
-	exTexture2 = Texture2D {img};
+	// Example texture 2
+	// exTexture2 = textureManager.load("res/textures/gamzee.png");
+	exTexture2 = textureManager.load("res/textures/john.png", MipFilter::Kaiser);
 	
 	
 	// -- Set up some OpenGL settings
@@ -126,11 +112,16 @@ Renderer::Renderer()
 	// Set background color to black
 	// glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 	
+	// Enable alpha blending (sprites are drawn back to front)
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	
 	// Set wireframe mode
 	// glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 }
 
 Renderer::~Renderer() {
+	trackDeallocation(MemoryTag::BufferGPU, exBufferBytes);
 }
 
 
@@ -141,30 +132,87 @@ Renderer::~Renderer() {
 void Renderer::setWindowSize(const int width, const int height) {
 	// Set viewport
 	glViewport(0, 0, width, height);
+	camera.setViewportSize(width, height);
+	
+	// One world unit per pixel, origin at the bottom left corner
+	overlayCamera.setViewportSize(width, height);
+	overlayCamera.setOrthographic(static_cast<float>(height));
+	overlayCamera.setPosition(Vec3 {width * 0.5f, height * 0.5f, 0.0f});
 }
 
-void Renderer::drawFrame() {
+void Renderer::drawFrame(float time) {
+	// Time since the last frame (for the debug overlay)
+	auto frameStart = std::chrono::steady_clock::now();
+	std::chrono::duration<float> frameTime = frameStart - lastFrameTime;
+	lastFrameTime = frameStart;
+	
+	profiler.beginFrame();
+	profiler.beginPhase(RenderPhase::Scene);
+	
 	// Clear frame and depth buffer
 	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 	glClear(GL_COLOR_BUFFER_BIT);
 	// glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); XXX
 	
+	// Upload camera matrices and time once for all shader programs
+	frameUniforms.update(camera, time);
+	
 	// Activate shader
-	shaderProgram.useProgram();
+	shaderProgram->useProgram();
 	
-	// Bind textures
+	// Set object transformation
+	glUniformMatrix4fv(shaderProgram->getUniformLocation("model"), 1, GL_FALSE,
+		transformSystem.getWorldMatrix(exTransform).data());
+	countUniformUpload();
+	
+	// Bind textures (texture 0 if not resident yet)
+	const Texture2D* texture1 = textureManager.get(exTexture1);
 	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, exTexture1.getTextureID());
-	glUniform1i(shaderProgram.getUniformLocation("texSampler1"), 0);
+	glBindTexture(GL_TEXTURE_2D, texture1 != nullptr ? texture1->getTextureID() : 0);
+	glUniform1i(shaderProgram->getUniformLocation("texSampler1"), 0);
 	
+	const Texture2D* texture2 = textureManager.get(exTexture2);
 	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, exTexture2.getTextureID());
-	glUniform1i(shaderProgram.getUniformLocation("texSampler2"), 1);
+	glBindTexture(GL_TEXTURE_2D, texture2 != nullptr ? texture2->getTextureID() : 0);
+	glUniform1i(shaderProgram->getUniformLocation("texSampler2"), 1);
+	countTextureBind();
+	countTextureBind();
+	countUniformUpload(2);
 	
 	// Draw example object
 	glBindVertexArray(exVAO);
 	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 	glBindVertexArray(0);
+	countDrawCall(2);
+	
+	profiler.beginPhase(RenderPhase::Tilemaps);
+	
+	// Draw visible chunks of the tilemap layers (skipping those whose
+	// tileset is not resident yet)
+	for (auto& layer : tilemapLayers) {
+		const Texture2D* tileset = textureManager.get(layer->getTileset());
+		if (tileset != nullptr) {
+			layer->draw(camera, tileset->getTextureID());
+		}
+	}
+	
+	// Draw sprites of all entities in view
+	profiler.beginPhase(RenderPhase::Sprites);
+	drawSprites();
+	
+	// Draw particles
+	profiler.beginPhase(RenderPhase::Particles);
+	for (auto& particleSystem : particleSystems) {
+		particleSystem->draw();
+	}
+	
+	// Draw text and the debug overlay on top
+	profiler.beginPhase(RenderPhase::Overlay);
+	drawOverlay(time, frameTime.count());
+	profiler.endPhase();
+	
+	// Upload newly loaded textures, enforce texture memory budget
+	textureManager.update();
 	
 	// RenderProgram will swap buffers now
 }
@@ -175,4 +223,158 @@ bool Renderer::toggleWireframeMode() {
 	return wireframeMode;
 }
 
+bool Renderer::toggleDebugOverlay() {
+	debugOverlayVisible = !debugOverlayVisible;
+	return debugOverlayVisible;
+}
+
+TilemapLayer& Renderer::addTilemapLayer(std::uint32_t width, std::uint32_t height, const Vec2& tileSize,
+	const Vec2& origin, const std::string& tilesetPath, std::uint32_t columns, std::uint32_t rows)
+{
+	TextureHandle tileset = textureManager.load(tilesetPath);
+	tilemapLayers.push_back(std::make_unique<TilemapLayer>(width, height, tileSize, origin, tileset, columns, rows));
+	return *tilemapLayers.back();
+}
+
+ParticleSystem& Renderer::addParticleSystem(std::size_t maxParticles, ParticleBackend backend) {
+	if (backend == ParticleBackend::GPU) {
+		particleSystems.push_back(std::make_unique<GPUParticleSystem>(maxParticles));
+	}
+	else {
+		particleSystems.push_back(std::make_unique<CPUParticleSystem>(jobSystem, maxParticles));
+	}
+	return *particleSystems.back();
+}
+
+void Renderer::updateParticles(float dt) {
+	for (auto& particleSystem : particleSystems) {
+		particleSystem->update(dt);
+	}
+}
+
+void Renderer::drawText(const std::string& text, const Vec2& position, std::uint32_t scale, std::uint32_t color) {
+	queuedTexts.push_back(QueuedText {text, position, scale, color});
+}
+
+void Renderer::drawSprites() {
+	// Sprite with its world matrix (valid until the next TransformSystem
+	// update, like the component pointer until the next World change)
+	struct SpriteItem {
+		const Sprite* sprite;
+		const Mat4* transform;
+	};
+	
+	// -- Gather world space bounds of all sprites
+	FrameVector<SpriteItem> items {FrameAllocatorAdapter<SpriteItem>(frameAllocator)};
+	FrameVector<AABB> bounds {FrameAllocatorAdapter<AABB>(frameAllocator)};
+	
+	world.each<const TransformComponent, const Sprite>([&](const TransformComponent& transform, const Sprite& sprite) {
+		if (!transformSystem.contains(transform.handle)) {
+			return;
+		}
+		
+		const Mat4& matrix = transformSystem.getWorldMatrix(transform.handle);
+		Vec3 halfSize {sprite.size.x * 0.5f, sprite.size.y * 0.5f, 0.0f};
+		items.push_back(SpriteItem {&sprite, &matrix});
+		bounds.push_back(transformAABB(matrix, AABB {-halfSize, halfSize}));
+	});
+	
+	if (items.empty()) {
+		return;
+	}
+	
+	// -- Cull against the camera view
+	Frustum frustum = Frustum::fromMatrix(camera.getViewProjectionMatrix());
+	std::uint32_t* visible = frameAllocator.allocateArray<std::uint32_t>(items.size());
+	std::size_t visibleCount = cullAABBs(jobSystem, frustum, bounds.data(), items.size(), visible);
+	
+	// -- Batch the visible sprites (in submission order, skipping those
+	// whose texture is not resident yet)
+	spriteBatch.begin();
+	for (std::size_t i = 0; i < visibleCount; ++i) {
+		const SpriteItem& item = items[visible[i]];
+		const Texture2D* texture = textureManager.get(item.sprite->texture);
+		if (texture != nullptr) {
+			spriteBatch.draw(texture->getTextureID(), *item.transform, *item.sprite);
+		}
+	}
+	spriteBatch.end();
+}
+
+void Renderer::drawOverlay(float time, float frameTime) {
+	// Frame times are recorded even while the overlay is hidden
+	bool refreshDebugText = debugOverlay.update(frameTime);
+	if (queuedTexts.empty() && !debugOverlayVisible) {
+		return;
+	}
+	
+	// Switch the frame uniforms to window coordinates (the scene is done)
+	frameUniforms.update(overlayCamera, time);
+	
+	Vec2 windowSize = overlayCamera.getViewportSize();
+	overlayBatch.begin();
+	
+	if (debugOverlayVisible) {
+		if (refreshDebugText) {
+			debugOverlay.setText(buildDebugText());
+		}
+		debugOverlay.draw(overlayBatch, font, windowSize);
+	}
+	
+	for (const QueuedText& queued : queuedTexts) {
+		Vec2 topLeft {queued.position.x, windowSize.y - queued.position.y};
+		font.draw(overlayBatch, queued.text, topLeft, queued.scale, queued.color);
+	}
+	
+	overlayBatch.end();
+	queuedTexts.clear();
+}
+
+std::string Renderer::buildDebugText() const {
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(2);
+	
+	// -- Frame times
+	float averageFrameTime = debugOverlay.getAverageFrameTime();
+	out << "Frame: " << averageFrameTime << " ms avg ("
+	    << (averageFrameTime > 0.0f ? 1000.0f / averageFrameTime : 0.0f) << " fps), "
+	    << debugOverlay.getMaxFrameTime() << " ms max" << std::endl << std::endl;
+	
+	// -- Phase timings
+	out << "Phase        CPU ms   GPU ms" << std::endl;
+	for (std::size_t i = 0; i < static_cast<std::size_t>(RenderPhase::Count); ++i) {
+		RenderPhase phase = static_cast<RenderPhase>(i);
+		out << std::left << std::setw(10) << getRenderPhaseName(phase) << std::right
+		    << std::setw(9) << profiler.getCPUTime(phase)
+		    << std::setw(9) << profiler.getGPUTime(phase) << std::endl;
+	}
+	out << std::endl;
+	
+	// -- Scene contents
+	std::size_t drawnChunks = 0;
+	for (const auto& layer : tilemapLayers) {
+		drawnChunks += layer->getDrawnChunkCount();
+	}
+	std::size_t particles = 0;
+	for (const auto& particleSystem : particleSystems) {
+		particles += particleSystem->size();
+	}
+	out << "Sprites: " << spriteBatch.getQuadCount() << " quads, "
+	    << spriteBatch.getDrawCallCount() << " draw calls" << std::endl;
+	out << "Tilemap chunks: " << drawnChunks << std::endl;
+	out << "Particles: " << particles << " in " << particleSystems.size() << " systems" << std::endl << std::endl;
+	
+	// -- Work submitted to OpenGL
+	printRenderStats(out, debugStatsFrames);
+	out << std::endl;
+	
+	// -- Memory
+	const double mebibyte = 1024.0 * 1024.0;
+	out << "Textures: " << textureManager.getResidentBytes() / mebibyte << " / "
+	    << textureManager.getBudget() / mebibyte << " MiB" << std::endl << std::endl;
+	printMemoryStats(out);
+	
+	return out.str();
+}
+
 } // end namespace bdEngine
@@ -5,9 +5,33 @@
 #include <GL/glew.h>
 #include "GLFWpp.h"
 
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Camera.h"
+#include "Culling.h"
+#include "DebugOverlay.h"
+#include "FrameAllocator.h"
+#include "FrameProfiler.h"
+#include "Font.h"
+#include "FrameUniforms.h"
 #include "GLShaderProgram.h"
+#include "GPUParticleSystem.h"
 #include "Image.h"
+#include "JobSystem.h"
+#include "MemoryStats.h"
+#include "MipChain.h"
+#include "ParticleSystem.h"
+#include "RenderStats.h"
+#include "ResourceCache.h"
+#include "SpriteBatch.h"
 #include "Texture2D.h"
+#include "TextureManager.h"
+#include "Tilemap.h"
+#include "TransformSystem.h"
+#include "World.h"
 
 namespace bdEngine {
 
@@ -16,7 +40,7 @@ public:
 	/*******************************************************************
 	 * Construction and destruction
 	 *******************************************************************/
-	Renderer();
+	Renderer(JobSystem& jobSystem, FrameAllocator& frameAllocator, TransformSystem& transformSystem, World& world);
 	~Renderer();
 	
 	// --- Forbid copy and move operations
@@ -30,30 +54,140 @@ public:
 	 * Drawing / Rendering
 	 *******************************************************************/
 	
-	// Set the size of the window
+	// Set the size of the framebuffer (in pixels)
 	void setWindowSize(const int width, const int height);
 	
-	// Draw one frame
-	void drawFrame();
+	// Draw one frame at the given simulation time (in seconds, for shaders)
+	void drawFrame(float time);
 	
 	// Switch between wireframe and filling mode
 	bool toggleWireframeMode();
 	
+	// Show or hide the debug overlay (frame times, timings, statistics)
+	bool toggleDebugOverlay();
+	
+	
+	/*******************************************************************
+	 * Properties
+	 *******************************************************************/
+	
+	// Camera the scene is rendered with
+	Camera& getCamera() {
+		return camera;
+	}
+	
+	
+	/*******************************************************************
+	 * Tilemaps and particles
+	 *******************************************************************/
+	
+	// Add a tilemap layer (drawn behind sprites, in order of creation)
+	// using a tileset of columns x rows tiles loaded from a file
+	TilemapLayer& addTilemapLayer(std::uint32_t width, std::uint32_t height, const Vec2& tileSize,
+		const Vec2& origin, const std::string& tilesetPath, std::uint32_t columns, std::uint32_t rows);
+	
+	// Add a particle system simulated on the CPU or the GPU (drawn in front
+	// of sprites)
+	ParticleSystem& addParticleSystem(std::size_t maxParticles, ParticleBackend backend = ParticleBackend::CPU);
+	
+	// Advance all particle systems by dt seconds
+	void updateParticles(float dt);
+	
+	
+	/*******************************************************************
+	 * Text
+	 *******************************************************************/
+	
+	// Draw a text on top of the scene in the next frame (position of its
+	// top left corner in pixels from the top left corner of the window)
+	void drawText(const std::string& text, const Vec2& position, std::uint32_t scale = 2,
+		std::uint32_t color = 0xFFFFFFFF);
+	
+	// Font used for all text
+	Font& getFont() {
+		return font;
+	}
+	
 private:
-	// Shader program object
-	GLShaderProgram shaderProgram;
+	// Culls the sprites of the world against the camera and draws the
+	// visible ones
+	void drawSprites();
+	
+	// Draws the texts queued for this frame and the debug overlay in window
+	// coordinates
+	void drawOverlay(float time, float frameTime);
+	
+	// Returns the statistics shown by the debug overlay
+	std::string buildDebugText() const;
+	
+	// Text queued with drawText()
+	struct QueuedText {
+		std::string text;
+		Vec2 position;
+		std::uint32_t scale;
+		std::uint32_t color;
+	};
+	
+	// Worker threads (used for culling)
+	JobSystem& jobSystem;
+	
+	// Per-frame memory for transient render data
+	FrameAllocator& frameAllocator;
+	
+	// Transform hierarchy of the scene
+	TransformSystem& transformSystem;
+	
+	// Entities of the scene
+	World& world;
+	
+	// Camera and the uniform buffer with its matrices
+	Camera camera;
+	FrameUniforms frameUniforms;
+	
+	// Batch for all sprites
+	SpriteBatch spriteBatch;
+	
+	// Tilemap layers, back to front
+	std::vector<std::unique_ptr<TilemapLayer>> tilemapLayers;
+	
+	// Particle systems
+	std::vector<std::unique_ptr<ParticleSystem>> particleSystems;
+	
+	// Text drawn on top of the scene, with a camera showing the window in
+	// pixels and a batch of its own
+	Font font;
+	Camera overlayCamera;
+	SpriteBatch overlayBatch;
+	std::vector<QueuedText> queuedTexts;
+	
+	// Debug overlay and the timings it shows
+	DebugOverlay debugOverlay;
+	FrameProfiler profiler;
+	std::chrono::steady_clock::time_point lastFrameTime;
+	
+	// Shaders and other file resources shared between users
+	ResourceCache resourceCache;
+	
+	// Shader program object (from the resource cache)
+	std::shared_ptr<GLShaderProgram> shaderProgram;
 	
 	// XXX Example objects
 	GLuint exVAO;  // Vertex Array Object
 	GLuint exVBO;  // Vertex Buffer Object
 	GLuint exEBO;  // Element Buffer Object
+	std::size_t exBufferBytes = 0;
+	TransformHandle exTransform;
+	
+	// Texture manager (owns all textures)
+	TextureManager textureManager;
 	
 	// Example textures
-	Texture2D exTexture1;
-	Texture2D exTexture2;
+	TextureHandle exTexture1;
+	TextureHandle exTexture2;
 	
 	// Settings
 	bool wireframeMode = false;
+	bool debugOverlayVisible = false;
 };
 
 } // end namespace bdEngine
@@ -0,0 +1,155 @@
+#include "ResourceCache.h"
+#include "MemoryStats.h"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Internal helpers
+ *******************************************************************/
+
+namespace {
+	// Removes expired entries from a cache map, returns number of removed entries
+	template <class T>
+	std::size_t purgeMap(std::unordered_map<std::string, std::weak_ptr<T>>& map) {
+		std::size_t removed = 0;
+		for (auto it = map.begin(); it != map.end(); ) {
+			if (it->second.expired()) {
+				it = map.erase(it);
+				++removed;
+			}
+			else {
+				++it;
+			}
+		}
+		return removed;
+	}
+	
+	// Shader source text (counted as MemoryTag::Shader)
+	using ShaderSource = std::basic_string<char, std::char_traits<char>, TrackingAllocator<char, MemoryTag::Shader>>;
+	
+	// Reads a whole text file
+	ShaderSource readFile(const std::string& filename) {
+		std::ifstream file {filename};
+		if (!file) {
+			throw std::runtime_error("Cannot open file '" + filename + "'.");
+		}
+		
+		return ShaderSource {std::istreambuf_iterator<char> {file}, std::istreambuf_iterator<char> {}};
+	}
+	
+	// Compiles a shader from a file and adds it to a program
+	void addShaderFile(GLShaderProgram& program, const std::string& filename, GLenum shaderType) {
+		ShaderSource source = readFile(filename);
+		const GLchar* sourcePtr = source.c_str();
+		
+		if (!program.addShader(&sourcePtr, shaderType)) {
+			throw std::runtime_error("Cannot compile shader '" + filename + "'.");
+		}
+	}
+}
+
+
+/*******************************************************************
+ * Resources
+ *******************************************************************/
+
+std::shared_ptr<Image> ResourceCache::getImage(const std::string& filename) {
+	std::string path = normalizePath(filename);
+	
+	auto it = images_.find(path);
+	if (it != images_.end()) {
+		if (std::shared_ptr<Image> image = it->second.lock()) {
+			return image;
+		}
+	}
+	
+	// Only add an entry once loading succeeded
+	std::shared_ptr<Image> image = std::make_shared<Image>(path.c_str());
+	images_[path] = image;
+	return image;
+}
+
+std::shared_ptr<GLShaderProgram> ResourceCache::getShaderProgram(const std::string& vertexFilename,
+	const std::string& fragmentFilename)
+{
+	std::string vertexPath = normalizePath(vertexFilename);
+	std::string fragmentPath = normalizePath(fragmentFilename);
+	std::string key = vertexPath + "|" + fragmentPath;
+	
+	auto it = shaderPrograms_.find(key);
+	if (it != shaderPrograms_.end()) {
+		if (std::shared_ptr<GLShaderProgram> program = it->second.lock()) {
+			return program;
+		}
+	}
+	
+	std::shared_ptr<GLShaderProgram> program = std::make_shared<GLShaderProgram>();
+	addShaderFile(*program, vertexPath, GL_VERTEX_SHADER);
+	addShaderFile(*program, fragmentPath, GL_FRAGMENT_SHADER);
+	
+	if (!program->linkShaders()) {
+		throw std::runtime_error("Cannot link shader program '" + key + "'.");
+	}
+	shaderPrograms_[key] = program;
+	return program;
+}
+
+std::size_t ResourceCache::purge() {
+	return purgeMap(images_) + purgeMap(shaderPrograms_);
+}
+
+void ResourceCache::clear() {
+	images_.clear();
+	shaderPrograms_.clear();
+}
+
+
+/*******************************************************************
+ * Helpers
+ *******************************************************************/
+
+std::string ResourceCache::normalizePath(const std::string& path) {
+	bool absolute = (!path.empty() && (path[0] == '/' || path[0] == '\\'));
+	
+	// Split into components, dropping empty ones and "."
+	std::vector<std::string> components;
+	std::string component;
+	
+	for (std::size_t i = 0; i <= path.size(); ++i) {
+		if (i == path.size() || path[i] == '/' || path[i] == '\\') {
+			if (component == "..") {
+				if (!components.empty() && components.back() != "..") {
+					components.pop_back();
+				}
+				else if (!absolute) {
+					// Leading ".." of a relative path can't be resolved lexically
+					components.push_back(component);
+				}
+			}
+			else if (!component.empty() && component != ".") {
+				components.push_back(component);
+			}
+			component.clear();
+		}
+		else {
+			component += path[i];
+		}
+	}
+	
+	// Join with forward slashes
+	std::string result = (absolute ? "/" : "");
+	for (std::size_t i = 0; i < components.size(); ++i) {
+		if (i > 0) {
+			result += '/';
+		}
+		result += components[i];
+	}
+	return result;
+}
+
+} // end namespace bdEngine
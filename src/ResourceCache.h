@@ -0,0 +1,91 @@
+#ifndef _BDENGINE_RESOURCECACHE_H
+#define _BDENGINE_RESOURCECACHE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "GLShaderProgram.h"
+#include "Image.h"
+
+namespace bdEngine {
+
+/*!
+ * Deduplicates resource loads.
+ *
+ * Resources are identified by their normalized file paths and handed out as
+ * shared pointers, so loading the same file twice returns the object that is
+ * already loaded. The cache itself only holds weak references: a resource is
+ * released as soon as nobody uses it anymore, and loading it again afterwards
+ * reloads it. purge() removes the entries of released resources.
+ *
+ * Textures are not cached here, TextureManager owns and deduplicates them.
+ * Shader programs are created with the GL context, so the cache must only be
+ * used from the render thread.
+ */
+class ResourceCache {
+public:
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates an empty cache.
+	 */
+	ResourceCache() {}
+	
+	// --- Forbid copy and move operations
+	ResourceCache(const ResourceCache& other)            = delete;  // copy constructor
+	ResourceCache& operator=(const ResourceCache& other) = delete;  // copy assignment
+	ResourceCache(ResourceCache&& other)                 = delete;  // move constructor
+	ResourceCache& operator=(ResourceCache&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Resources
+	 *******************************************************************/
+	/*!
+	 * Returns the image loaded from a file, loading it if necessary.
+	 * Throws std::runtime_error if loading fails.
+	 */
+	std::shared_ptr<Image> getImage(const std::string& filename);
+	
+	/*!
+	 * Returns the shader program linked from a vertex and a fragment shader
+	 * source file, compiling it if necessary. Throws std::runtime_error if
+	 * a file can't be read or the program can't be built.
+	 */
+	std::shared_ptr<GLShaderProgram> getShaderProgram(const std::string& vertexFilename,
+		const std::string& fragmentFilename);
+	
+	/*!
+	 * Removes the entries of resources that have been released.
+	 * Returns the number of removed entries.
+	 */
+	std::size_t purge();
+	
+	/*!
+	 * Forgets all resources. Resources still in use stay alive, but will be
+	 * loaded again when requested from the cache.
+	 */
+	void clear();
+	
+	
+	/*******************************************************************
+	 * Helpers
+	 *******************************************************************/
+	/*!
+	 * Normalizes a file path lexically, so that different spellings of the
+	 * same path ("res//a/../b.png", "./res/b.png") map to the same key.
+	 */
+	static std::string normalizePath(const std::string& path);
+
+private:
+	// Cached resources by key
+	std::unordered_map<std::string, std::weak_ptr<Image>> images_;
+	std::unordered_map<std::string, std::weak_ptr<GLShaderProgram>> shaderPrograms_;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_RESOURCECACHE_H */
@@ -0,0 +1,415 @@
+#include "SpatialIndex.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace bdEngine {
+
+const std::uint32_t LooseQuadtree::noNode;
+
+namespace {
+	// Walks the cells of a grid (cell (0, 0) starting at the origin) along
+	// the ray origin + t * direction from tStart to tEnd, in order, calling
+	// visit(x, y, tEnter) until it returns false (Amanatides & Woo)
+	template <class Visit>
+	void traverseGrid(const Vec2& origin, const Vec2& direction, float tStart, float tEnd,
+		float cellSize, Visit&& visit)
+	{
+		const float infinity = std::numeric_limits<float>::infinity();
+		Vec2 p = origin + direction * tStart;
+		std::int32_t x = static_cast<std::int32_t>(std::floor(p.x / cellSize));
+		std::int32_t y = static_cast<std::int32_t>(std::floor(p.y / cellSize));
+		
+		std::int32_t stepX = (direction.x > 0 ? 1 : (direction.x < 0 ? -1 : 0));
+		std::int32_t stepY = (direction.y > 0 ? 1 : (direction.y < 0 ? -1 : 0));
+		float tDeltaX = (stepX != 0 ? cellSize / std::fabs(direction.x) : infinity);
+		float tDeltaY = (stepY != 0 ? cellSize / std::fabs(direction.y) : infinity);
+		
+		// Parameter of the next vertical and horizontal cell border
+		float tNextX = (stepX != 0 ? tStart + ((x + (stepX > 0 ? 1 : 0)) * cellSize - p.x) / direction.x : infinity);
+		float tNextY = (stepY != 0 ? tStart + ((y + (stepY > 0 ? 1 : 0)) * cellSize - p.y) / direction.y : infinity);
+		
+		float t = tStart;
+		while (t <= tEnd) {
+			if (!visit(x, y, t)) {
+				return;
+			}
+			if (tNextX < tNextY) {
+				t = tNextX;
+				tNextX += tDeltaX;
+				x += stepX;
+			}
+			else {
+				t = tNextY;
+				tNextY += tDeltaY;
+				y += stepY;
+			}
+		}
+	}
+	
+	// Keeps the nearer of two hits
+	void testHit(std::uint32_t id, const Rect& bounds, const Vec2& origin, const Vec2& direction,
+		float maxDistance, RaycastHit& best, bool& found)
+	{
+		float t;
+		if (intersectRay(bounds, origin, direction, found ? best.distance : maxDistance, t)
+			&& (!found || t < best.distance))
+		{
+			best.id = id;
+			best.distance = t;
+			found = true;
+		}
+	}
+	
+	void checkRay(float maxDistance) {
+		if (!std::isfinite(maxDistance) || maxDistance < 0) {
+			throw std::invalid_argument("Raycast distance has to be finite.");
+		}
+	}
+}
+
+
+/*******************************************************************
+ * SpatialHash
+ *******************************************************************/
+
+// Constructor
+SpatialHash::SpatialHash(float cellSize)
+	: cellSize_ {cellSize}
+	, invCellSize_ {1.0f / cellSize}
+{
+	if (!(cellSize > 0)) {
+		throw std::invalid_argument("Cell size has to be positive.");
+	}
+}
+
+void SpatialHash::insert(std::uint32_t id, const Rect& bounds) {
+	if (contains(id)) {
+		throw std::invalid_argument("Object is already in the spatial hash.");
+	}
+	if (id >= items_.size()) {
+		items_.resize(id + 1);
+	}
+	
+	Item& item = items_[id];
+	item.bounds = bounds;
+	item.cells = getCellRange(bounds);
+	item.alive = true;
+	addToCells(id, item.cells);
+	++count_;
+}
+
+void SpatialHash::update(std::uint32_t id, const Rect& bounds) {
+	if (!contains(id)) {
+		insert(id, bounds);
+		return;
+	}
+	
+	// Only touch the cells if the object moved to other ones
+	Item& item = items_[id];
+	CellRange cells = getCellRange(bounds);
+	if (!(cells == item.cells)) {
+		removeFromCells(id, item.cells);
+		addToCells(id, cells);
+		item.cells = cells;
+	}
+	item.bounds = bounds;
+}
+
+void SpatialHash::remove(std::uint32_t id) {
+	if (!contains(id)) {
+		return;
+	}
+	
+	removeFromCells(id, items_[id].cells);
+	items_[id].alive = false;
+	--count_;
+}
+
+void SpatialHash::clear() {
+	cells_.clear();
+	items_.clear();
+	count_ = 0;
+}
+
+bool SpatialHash::raycast(const Vec2& origin, const Vec2& direction, float maxDistance, RaycastHit& hit) const {
+	checkRay(maxDistance);
+	
+	// Objects spanning several cells may be tested more than once, which
+	// doesn't change the result
+	bool found = false;
+	traverseGrid(origin, direction, 0.0f, maxDistance, cellSize_,
+		[&](std::int32_t x, std::int32_t y, float tEnter) {
+			// Hits in later cells can't be nearer than one already found
+			if (found && tEnter > hit.distance) {
+				return false;
+			}
+			
+			auto it = cells_.find(getCellKey(x, y));
+			if (it != cells_.end()) {
+				for (std::uint32_t id : it->second) {
+					testHit(id, items_[id].bounds, origin, direction, maxDistance, hit, found);
+				}
+			}
+			return true;
+		});
+	
+	if (found) {
+		hit.point = origin + direction * hit.distance;
+	}
+	return found;
+}
+
+void SpatialHash::addToCells(std::uint32_t id, const CellRange& range) {
+	for (std::int32_t y = range.y0; y <= range.y1; ++y) {
+		for (std::int32_t x = range.x0; x <= range.x1; ++x) {
+			cells_[getCellKey(x, y)].push_back(id);
+		}
+	}
+}
+
+void SpatialHash::removeFromCells(std::uint32_t id, const CellRange& range) {
+	for (std::int32_t y = range.y0; y <= range.y1; ++y) {
+		for (std::int32_t x = range.x0; x <= range.x1; ++x) {
+			auto it = cells_.find(getCellKey(x, y));
+			std::vector<std::uint32_t>& ids = it->second;
+			
+			// Order within a cell doesn't matter: swap and pop
+			auto pos = std::find(ids.begin(), ids.end(), id);
+			*pos = ids.back();
+			ids.pop_back();
+			
+			if (ids.empty()) {
+				cells_.erase(it);
+			}
+		}
+	}
+}
+
+
+/*******************************************************************
+ * LooseQuadtree
+ *******************************************************************/
+
+// Constructor
+LooseQuadtree::LooseQuadtree(const Rect& worldBounds, int maxDepth)
+	: origin_ {worldBounds.min}
+	, worldSize_ {std::max(worldBounds.getSize().x, worldBounds.getSize().y)}
+	, maxDepth_ {maxDepth}
+{
+	if (maxDepth < 0 || maxDepth > 12) {
+		throw std::invalid_argument("Quadtree depth has to be between 0 and 12.");
+	}
+	if (!(worldSize_ > 0)) {
+		throw std::invalid_argument("Quadtree bounds must not be empty.");
+	}
+	
+	// Level d has 4^d nodes
+	std::uint32_t nodeCount = 0;
+	for (int level = 0; level <= maxDepth; ++level) {
+		levelOffsets_.push_back(nodeCount);
+		nodeCount += 1u << (2 * level);
+	}
+	heads_.assign(nodeCount, noNode);
+	levelCounts_.assign(maxDepth + 1, 0);
+}
+
+void LooseQuadtree::insert(std::uint32_t id, const Rect& bounds) {
+	if (contains(id)) {
+		throw std::invalid_argument("Object is already in the quadtree.");
+	}
+	if (id >= items_.size()) {
+		items_.resize(id + 1);
+		itemLevels_.resize(id + 1);
+	}
+	
+	int level;
+	std::uint32_t node = selectNode(bounds, level);
+	items_[id].bounds = bounds;
+	link(id, node, level);
+	++count_;
+}
+
+void LooseQuadtree::update(std::uint32_t id, const Rect& bounds) {
+	if (!contains(id)) {
+		insert(id, bounds);
+		return;
+	}
+	
+	// Only relink if the object belongs to another node now
+	int level;
+	std::uint32_t node = selectNode(bounds, level);
+	if (node != items_[id].node) {
+		unlink(id);
+		link(id, node, level);
+	}
+	items_[id].bounds = bounds;
+}
+
+void LooseQuadtree::remove(std::uint32_t id) {
+	if (!contains(id)) {
+		return;
+	}
+	
+	unlink(id);
+	--count_;
+}
+
+void LooseQuadtree::clear() {
+	std::fill(heads_.begin(), heads_.end(), noNode);
+	std::fill(levelCounts_.begin(), levelCounts_.end(), 0);
+	items_.clear();
+	itemLevels_.clear();
+	count_ = 0;
+}
+
+bool LooseQuadtree::raycast(const Vec2& origin, const Vec2& direction, float maxDistance, RaycastHit& hit) const {
+	checkRay(maxDistance);
+	
+	bool found = false;
+	for (int level = 0; level <= maxDepth_; ++level) {
+		if (levelCounts_[level] == 0) {
+			continue;
+		}
+		
+		// The root (which also holds objects outside the world) is tested
+		// completely
+		if (level == 0) {
+			for (std::uint32_t id = heads_[0]; id != noNode; id = items_[id].next) {
+				testHit(id, items_[id].bounds, origin, direction, maxDistance, hit, found);
+			}
+			continue;
+		}
+		
+		// Clip the ray to the loose bounds of the level
+		const float nodeSize = getNodeSize(level);
+		const std::int32_t nodes = 1 << level;
+		const Rect looseWorld {
+			origin_ - Vec2 {nodeSize, nodeSize} * 0.5f,
+			origin_ + Vec2 {worldSize_ + nodeSize * 0.5f, worldSize_ + nodeSize * 0.5f}
+		};
+		float tStart = 0.0f;
+		if (!intersectRay(looseWorld, origin, direction, maxDistance, tStart)) {
+			continue;
+		}
+		// (Exit distance: entry distance of the reversed ray from the end.
+		// If rounding makes a grazing ray miss, only the entry node is left.)
+		float tEnd = 0.0f;
+		if (intersectRay(looseWorld, origin + direction * maxDistance, -direction, maxDistance - tStart, tEnd)) {
+			tEnd = maxDistance - tEnd;
+		}
+		else {
+			tEnd = tStart;
+		}
+		
+		// An object hit at some point is stored in the node containing that
+		// point or one of its neighbors (loose bounds reach half a node
+		// beyond the node)
+		traverseGrid(origin - origin_, direction, tStart, tEnd, nodeSize,
+			[&](std::int32_t x, std::int32_t y, float tEnter) {
+				if (found && tEnter > hit.distance) {
+					return false;
+				}
+				
+				for (std::int32_t ny = std::max(y - 1, 0); ny <= std::min(y + 1, nodes - 1); ++ny) {
+					for (std::int32_t nx = std::max(x - 1, 0); nx <= std::min(x + 1, nodes - 1); ++nx) {
+						for (std::uint32_t id = heads_[getNode(level, nx, ny)]; id != noNode; id = items_[id].next) {
+							testHit(id, items_[id].bounds, origin, direction, maxDistance, hit, found);
+						}
+					}
+				}
+				return true;
+			});
+	}
+	
+	if (found) {
+		hit.point = origin + direction * hit.distance;
+	}
+	return found;
+}
+
+std::uint32_t LooseQuadtree::selectNode(const Rect& bounds, int& level) const {
+	// Objects that are not completely inside the world go to the root
+	Vec2 relMin = bounds.min - origin_;
+	Vec2 relMax = bounds.max - origin_;
+	if (relMin.x < 0 || relMin.y < 0 || relMax.x > worldSize_ || relMax.y > worldSize_) {
+		level = 0;
+		return 0;
+	}
+	
+	// Deepest level whose nodes are at least as large as the object (the
+	// loose border then covers it, wherever its center is in the node)
+	Vec2 size = bounds.getSize();
+	float extent = std::max(size.x, size.y);
+	level = 0;
+	while (level < maxDepth_ && getNodeSize(level + 1) >= extent) {
+		++level;
+	}
+	
+	// Node containing the center
+	const float nodeSize = getNodeSize(level);
+	const std::int32_t nodes = 1 << level;
+	Vec2 center = bounds.getCenter() - origin_;
+	std::int32_t x = std::min(static_cast<std::int32_t>(center.x / nodeSize), nodes - 1);
+	std::int32_t y = std::min(static_cast<std::int32_t>(center.y / nodeSize), nodes - 1);
+	return getNode(level, x, y);
+}
+
+bool LooseQuadtree::getNodeRange(int level, const Rect& area, NodeRange& range) const {
+	// The root holds everything outside the world too
+	if (level == 0) {
+		range = NodeRange {0, 0, 0, 0};
+		return true;
+	}
+	
+	// Nodes whose bounds, extended by half a node, intersect the area
+	const float nodeSize = getNodeSize(level);
+	const float border = nodeSize * 0.5f;
+	const std::int32_t nodes = 1 << level;
+	float x0 = std::floor((area.min.x - border - origin_.x) / nodeSize);
+	float y0 = std::floor((area.min.y - border - origin_.y) / nodeSize);
+	float x1 = std::floor((area.max.x + border - origin_.x) / nodeSize);
+	float y1 = std::floor((area.max.y + border - origin_.y) / nodeSize);
+	if (x1 < 0 || y1 < 0 || x0 >= nodes || y0 >= nodes) {
+		return false;
+	}
+	
+	range.x0 = static_cast<std::int32_t>(std::max(x0, 0.0f));
+	range.y0 = static_cast<std::int32_t>(std::max(y0, 0.0f));
+	range.x1 = static_cast<std::int32_t>(std::min(x1, static_cast<float>(nodes - 1)));
+	range.y1 = static_cast<std::int32_t>(std::min(y1, static_cast<float>(nodes - 1)));
+	return true;
+}
+
+void LooseQuadtree::link(std::uint32_t id, std::uint32_t node, int level) {
+	Item& item = items_[id];
+	item.node = node;
+	item.prev = noNode;
+	item.next = heads_[node];
+	if (item.next != noNode) {
+		items_[item.next].prev = id;
+	}
+	heads_[node] = id;
+	
+	itemLevels_[id] = static_cast<std::uint8_t>(level);
+	++levelCounts_[level];
+}
+
+void LooseQuadtree::unlink(std::uint32_t id) {
+	Item& item = items_[id];
+	if (item.prev != noNode) {
+		items_[item.prev].next = item.next;
+	}
+	else {
+		heads_[item.node] = item.next;
+	}
+	if (item.next != noNode) {
+		items_[item.next].prev = item.prev;
+	}
+	
+	--levelCounts_[itemLevels_[id]];
+	item.node = noNode;
+}
+
+} // end namespace bdEngine
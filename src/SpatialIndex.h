@@ -0,0 +1,347 @@
+#ifndef _BDENGINE_SPATIALINDEX_H
+#define _BDENGINE_SPATIALINDEX_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Math.h"
+
+namespace bdEngine {
+
+/*!
+ * Result of a raycast against a spatial index.
+ */
+struct RaycastHit {
+	std::uint32_t id;
+	float distance;
+	Vec2 point;
+};
+
+
+/*******************************************************************
+ * SpatialHash
+ *******************************************************************/
+
+/*!
+ * Uniform grid over the (unbounded) 2D plane, with only non-empty cells
+ * stored in a hash map. Suited for dynamic objects of roughly the cell
+ * size: moving an object that stays in the same cells only stores its new
+ * bounds.
+ *
+ * Objects are identified by small integers chosen by the caller (e.g.
+ * Entity::getIndex()), which index internal arrays, so they should be dense.
+ * Queries may be run concurrently with each other, but not with changes.
+ */
+class SpatialHash {
+public:
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates an empty grid with square cells of the given size.
+	 */
+	explicit SpatialHash(float cellSize = 4.0f);
+	
+	
+	/*******************************************************************
+	 * Objects
+	 *******************************************************************/
+	/*!
+	 * Adds an object. Throws std::invalid_argument if the id is in use.
+	 */
+	void insert(std::uint32_t id, const Rect& bounds);
+	
+	/*!
+	 * Changes the bounds of an object (inserts it if necessary).
+	 */
+	void update(std::uint32_t id, const Rect& bounds);
+	
+	/*!
+	 * Removes an object (does nothing if the id is not in use).
+	 */
+	void remove(std::uint32_t id);
+	
+	/*!
+	 * Removes all objects.
+	 */
+	void clear();
+	
+	bool contains(std::uint32_t id) const {
+		return id < items_.size() && items_[id].alive;
+	}
+	
+	const Rect& getBounds(std::uint32_t id) const {
+		return items_[id].bounds;
+	}
+	
+	std::size_t size() const {
+		return count_;
+	}
+	
+	
+	/*******************************************************************
+	 * Queries
+	 *******************************************************************/
+	/*!
+	 * Calls func(id) once for every object whose bounds intersect area.
+	 */
+	template <class Func>
+	void queryRange(const Rect& area, Func&& func) const {
+		CellRange range = getCellRange(area);
+		
+		for (std::int32_t y = range.y0; y <= range.y1; ++y) {
+			for (std::int32_t x = range.x0; x <= range.x1; ++x) {
+				auto it = cells_.find(getCellKey(x, y));
+				if (it == cells_.end()) {
+					continue;
+				}
+				for (std::uint32_t id : it->second) {
+					// Objects spanning several cells are reported by their
+					// first cell inside the range only
+					const Item& item = items_[id];
+					std::int32_t firstX = (item.cells.x0 > range.x0 ? item.cells.x0 : range.x0);
+					std::int32_t firstY = (item.cells.y0 > range.y0 ? item.cells.y0 : range.y0);
+					if (x == firstX && y == firstY && item.bounds.intersects(area)) {
+						func(id);
+					}
+				}
+			}
+		}
+	}
+	
+	/*!
+	 * Calls func(id) for every object whose bounds contain the point.
+	 */
+	template <class Func>
+	void queryPoint(const Vec2& point, Func&& func) const {
+		auto it = cells_.find(getCellKey(toCell(point.x), toCell(point.y)));
+		if (it == cells_.end()) {
+			return;
+		}
+		for (std::uint32_t id : it->second) {
+			if (items_[id].bounds.contains(point)) {
+				func(id);
+			}
+		}
+	}
+	
+	/*!
+	 * Finds the nearest object hit by the ray origin + t * direction with
+	 * 0 <= t <= maxDistance (direction is normalized, maxDistance has to be
+	 * finite). Returns false if nothing was hit.
+	 */
+	bool raycast(const Vec2& origin, const Vec2& direction, float maxDistance, RaycastHit& hit) const;
+
+private:
+	// Inclusive range of cells covered by some bounds
+	struct CellRange {
+		std::int32_t x0, y0, x1, y1;
+		
+		bool operator==(const CellRange& other) const {
+			return x0 == other.x0 && y0 == other.y0 && x1 == other.x1 && y1 == other.y1;
+		}
+	};
+	
+	struct Item {
+		Rect bounds;
+		CellRange cells;
+		bool alive = false;
+	};
+	
+	std::int32_t toCell(float coordinate) const {
+		return static_cast<std::int32_t>(std::floor(coordinate * invCellSize_));
+	}
+	
+	CellRange getCellRange(const Rect& bounds) const {
+		return CellRange {toCell(bounds.min.x), toCell(bounds.min.y), toCell(bounds.max.x), toCell(bounds.max.y)};
+	}
+	
+	static std::uint64_t getCellKey(std::int32_t x, std::int32_t y) {
+		return (std::uint64_t(std::uint32_t(x)) << 32) | std::uint32_t(y);
+	}
+	
+	void addToCells(std::uint32_t id, const CellRange& range);
+	void removeFromCells(std::uint32_t id, const CellRange& range);
+	
+	float cellSize_;
+	float invCellSize_;
+	
+	// Object ids by cell
+	std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> cells_;
+	
+	// Objects by id
+	std::vector<Item> items_;
+	std::size_t count_ = 0;
+};
+
+
+/*******************************************************************
+ * LooseQuadtree
+ *******************************************************************/
+
+/*!
+ * Quadtree with loose nodes: every node covers its quadrant extended by
+ * half its size on all sides, so each object is stored in exactly one
+ * node, chosen by its size and center alone. Suited for static objects of
+ * very different sizes.
+ *
+ * The levels are stored as implicit grids (level d has 2^d x 2^d nodes),
+ * objects as linked lists per node. Objects that are not completely inside
+ * the world bounds are kept in the root.
+ *
+ * Objects are identified by small integers chosen by the caller like in a
+ * SpatialHash. Queries may be run concurrently with each other, but not
+ * with changes.
+ */
+class LooseQuadtree {
+public:
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates an empty quadtree covering the given (square or not) area
+	 * with at most maxDepth levels below the root.
+	 */
+	explicit LooseQuadtree(const Rect& worldBounds, int maxDepth = 8);
+	
+	
+	/*******************************************************************
+	 * Objects
+	 *******************************************************************/
+	/*!
+	 * Adds an object. Throws std::invalid_argument if the id is in use.
+	 */
+	void insert(std::uint32_t id, const Rect& bounds);
+	
+	/*!
+	 * Changes the bounds of an object (inserts it if necessary).
+	 */
+	void update(std::uint32_t id, const Rect& bounds);
+	
+	/*!
+	 * Removes an object (does nothing if the id is not in use).
+	 */
+	void remove(std::uint32_t id);
+	
+	/*!
+	 * Removes all objects.
+	 */
+	void clear();
+	
+	bool contains(std::uint32_t id) const {
+		return id < items_.size() && items_[id].node != noNode;
+	}
+	
+	const Rect& getBounds(std::uint32_t id) const {
+		return items_[id].bounds;
+	}
+	
+	std::size_t size() const {
+		return count_;
+	}
+	
+	
+	/*******************************************************************
+	 * Queries
+	 *******************************************************************/
+	/*!
+	 * Calls func(id) once for every object whose bounds intersect area.
+	 */
+	template <class Func>
+	void queryRange(const Rect& area, Func&& func) const {
+		for (int level = 0; level <= maxDepth_; ++level) {
+			if (levelCounts_[level] == 0) {
+				continue;
+			}
+			
+			NodeRange range;
+			if (!getNodeRange(level, area, range)) {
+				continue;
+			}
+			for (std::int32_t y = range.y0; y <= range.y1; ++y) {
+				for (std::int32_t x = range.x0; x <= range.x1; ++x) {
+					for (std::uint32_t id = heads_[getNode(level, x, y)]; id != noNode; id = items_[id].next) {
+						if (items_[id].bounds.intersects(area)) {
+							func(id);
+						}
+					}
+				}
+			}
+		}
+	}
+	
+	/*!
+	 * Calls func(id) for every object whose bounds contain the point.
+	 */
+	template <class Func>
+	void queryPoint(const Vec2& point, Func&& func) const {
+		queryRange(Rect {point, point}, [this, &point, &func](std::uint32_t id) {
+			if (items_[id].bounds.contains(point)) {
+				func(id);
+			}
+		});
+	}
+	
+	/*!
+	 * Finds the nearest object hit by the ray origin + t * direction with
+	 * 0 <= t <= maxDistance (direction is normalized, maxDistance has to be
+	 * finite). Returns false if nothing was hit.
+	 */
+	bool raycast(const Vec2& origin, const Vec2& direction, float maxDistance, RaycastHit& hit) const;
+
+private:
+	static const std::uint32_t noNode = 0xFFFFFFFF;
+	
+	// Inclusive range of nodes of one level
+	struct NodeRange {
+		std::int32_t x0, y0, x1, y1;
+	};
+	
+	struct Item {
+		Rect bounds;
+		std::uint32_t node = noNode;
+		std::uint32_t prev = noNode;
+		std::uint32_t next = noNode;
+	};
+	
+	// Returns the size of the nodes of a level (without the loose border)
+	float getNodeSize(int level) const {
+		return worldSize_ / static_cast<float>(1 << level);
+	}
+	
+	std::uint32_t getNode(int level, std::int32_t x, std::int32_t y) const {
+		return levelOffsets_[level] + static_cast<std::uint32_t>(y) * (1u << level) + static_cast<std::uint32_t>(x);
+	}
+	
+	// Returns the node an object with these bounds belongs to
+	std::uint32_t selectNode(const Rect& bounds, int& level) const;
+	
+	// Computes the nodes of a level whose loose bounds intersect area
+	bool getNodeRange(int level, const Rect& area, NodeRange& range) const;
+	
+	void link(std::uint32_t id, std::uint32_t node, int level);
+	void unlink(std::uint32_t id);
+	
+	// Square covered by the tree
+	Vec2 origin_;
+	float worldSize_;
+	int maxDepth_;
+	
+	// First node of every level, first object of every node, and the
+	// number of objects per level
+	std::vector<std::uint32_t> levelOffsets_;
+	std::vector<std::uint32_t> heads_;
+	std::vector<std::uint32_t> levelCounts_;
+	
+	// Objects by id, and the level they are stored on
+	std::vector<Item> items_;
+	std::vector<std::uint8_t> itemLevels_;
+	std::size_t count_ = 0;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_SPATIALINDEX_H */
@@ -0,0 +1,230 @@
+#include "SpriteBatch.h"
+#include "FrameUniforms.h"
+#include "MemoryStats.h"
+#include "RenderStats.h"
+
+#include <stdexcept>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Constants, shader sources
+ *******************************************************************/
+
+// Vertex shader source code (after FrameUniforms::glslBlock)
+static const GLchar* spriteVertexShaderSrc = R"__SRC__(
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texCoord;
+layout (location = 2) in vec4 color;
+
+out vec2 fragTexCoord;
+out vec4 fragColor;
+
+void main() {
+	gl_Position = viewProjection * vec4(position, 1.0);
+	// Flip texture coordinates vertically because otherwise textures are upside down.
+	fragTexCoord = vec2(texCoord.x, 1 - texCoord.y);
+	fragColor = color;
+}
+
+)__SRC__";
+
+// Fragment shader source code
+static const GLchar* spriteFragShaderSrc = R"__SRC__(
+#version 330 core
+
+in vec2 fragTexCoord;
+in vec4 fragColor;
+out vec4 color;
+
+uniform sampler2D texSampler;
+
+void main() {
+	color = texture(texSampler, fragTexCoord) * fragColor;
+}
+
+)__SRC__";
+
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+SpriteBatch::SpriteBatch(FrameAllocator& frameAllocator, std::size_t maxSprites)
+	: frameAllocator_ (frameAllocator)
+	, maxSprites_ {maxSprites}
+{
+	if (maxSprites == 0 || maxSprites * 4 > 0xFFFFFFFF) {
+		throw std::invalid_argument("Invalid number of sprites per batch.");
+	}
+	
+	// -- Compile and link shader program
+	const GLchar* vertexShaderSrcs[] = {FrameUniforms::glslBlock, spriteVertexShaderSrc};
+	shaderProgram_.addShader(vertexShaderSrcs, GL_VERTEX_SHADER, 2);
+	shaderProgram_.addShader(&spriteFragShaderSrc, GL_FRAGMENT_SHADER);
+	shaderProgram_.linkShaders();
+	shaderProgram_.bindUniformBlock(FrameUniforms::blockName, FrameUniforms::bindingPoint);
+	
+	// -- Indices never change: two triangles per quad
+	std::vector<GLuint, TrackingAllocator<GLuint, MemoryTag::Renderer>> indices (maxSprites * 6);
+	for (std::size_t i = 0; i < maxSprites; ++i) {
+		GLuint base = static_cast<GLuint>(i * 4);
+		GLuint* quad = &indices[i * 6];
+		quad[0] = base;
+		quad[1] = base + 1;
+		quad[2] = base + 2;
+		quad[3] = base;
+		quad[4] = base + 2;
+		quad[5] = base + 3;
+	}
+	
+	glGenVertexArrays(1, &vao_);
+	glGenBuffers(1, &vbo_);
+	glGenBuffers(1, &ebo_);
+	
+	glBindVertexArray(vao_);
+	
+	// Vertex buffer is filled every frame
+	glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+	glBufferData(GL_ARRAY_BUFFER, maxSprites * 4 * sizeof(SpriteVertex), nullptr, GL_STREAM_DRAW);
+	
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+	
+	bufferBytes_ = maxSprites * 4 * sizeof(SpriteVertex) + indices.size() * sizeof(GLuint);
+	trackAllocation(MemoryTag::BufferGPU, bufferBytes_);
+	
+	// Set vertex attributes pointers:
+	// -> location 0: position
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (GLvoid*)offsetof(SpriteVertex, x));
+	glEnableVertexAttribArray(0);
+	// -> location 1: texCoord
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (GLvoid*)offsetof(SpriteVertex, u));
+	glEnableVertexAttribArray(1);
+	// -> location 2: color (normalized bytes)
+	glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteVertex), (GLvoid*)offsetof(SpriteVertex, color));
+	glEnableVertexAttribArray(2);
+	
+	glBindVertexArray(0);
+}
+
+// Destructor
+SpriteBatch::~SpriteBatch() {
+	glDeleteVertexArrays(1, &vao_);
+	glDeleteBuffers(1, &vbo_);
+	glDeleteBuffers(1, &ebo_);
+	trackDeallocation(MemoryTag::BufferGPU, bufferBytes_);
+}
+
+
+/*******************************************************************
+ * Drawing
+ *******************************************************************/
+
+void SpriteBatch::begin() {
+	vertices_ = nullptr;
+	spriteCount_ = 0;
+	batches_.clear();
+	pendingQuadCount_ = 0;
+	pendingDrawCallCount_ = 0;
+}
+
+void SpriteBatch::draw(GLuint textureID, const Mat4& transform, const Sprite& sprite) {
+	// Corners are origin +- half the size along the transformed x and y axes
+	const float* m = transform.m;
+	float hw = sprite.size.x * 0.5f;
+	float hh = sprite.size.y * 0.5f;
+	Vec3 origin {m[12], m[13], m[14]};
+	Vec3 axisX = Vec3 {m[0], m[1], m[2]} * hw;
+	Vec3 axisY = Vec3 {m[4], m[5], m[6]} * hh;
+	
+	Vec3 p0 = origin - axisX - axisY;
+	Vec3 p1 = origin + axisX - axisY;
+	Vec3 p2 = origin + axisX + axisY;
+	Vec3 p3 = origin - axisX + axisY;
+	
+	SpriteVertex* v = addQuad(textureID);
+	v[0] = SpriteVertex {p0.x, p0.y, p0.z, sprite.uvMin.x, sprite.uvMin.y, sprite.color};
+	v[1] = SpriteVertex {p1.x, p1.y, p1.z, sprite.uvMax.x, sprite.uvMin.y, sprite.color};
+	v[2] = SpriteVertex {p2.x, p2.y, p2.z, sprite.uvMax.x, sprite.uvMax.y, sprite.color};
+	v[3] = SpriteVertex {p3.x, p3.y, p3.z, sprite.uvMin.x, sprite.uvMax.y, sprite.color};
+}
+
+void SpriteBatch::drawQuad(GLuint textureID, const SpriteVertex* corners) {
+	SpriteVertex* v = addQuad(textureID);
+	for (int i = 0; i < 4; ++i) {
+		v[i] = corners[i];
+	}
+}
+
+void SpriteBatch::end() {
+	flush();
+	quadCount_ = pendingQuadCount_;
+	drawCallCount_ = pendingDrawCallCount_;
+}
+
+
+/*******************************************************************
+ * Internal helpers
+ *******************************************************************/
+
+SpriteVertex* SpriteBatch::addQuad(GLuint textureID) {
+	if (spriteCount_ == maxSprites_) {
+		flush();
+	}
+	if (vertices_ == nullptr) {
+		vertices_ = frameAllocator_.allocateArray<SpriteVertex>(maxSprites_ * 4);
+	}
+	
+	// Extend the last batch or start a new one
+	std::uint32_t quad = static_cast<std::uint32_t>(spriteCount_++);
+	if (!batches_.empty() && batches_.back().textureID == textureID) {
+		++batches_.back().quadCount;
+	}
+	else {
+		batches_.push_back(Batch {textureID, quad, 1});
+	}
+	
+	return &vertices_[quad * 4];
+}
+
+void SpriteBatch::flush() {
+	if (spriteCount_ == 0) {
+		return;
+	}
+	
+	// Orphan the old buffer contents, so that the driver doesn't have to
+	// wait for draws still using them
+	glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+	glBufferData(GL_ARRAY_BUFFER, maxSprites_ * 4 * sizeof(SpriteVertex), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, spriteCount_ * 4 * sizeof(SpriteVertex), vertices_);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	countUpload(spriteCount_ * 4, spriteCount_ * 4 * sizeof(SpriteVertex));
+	
+	shaderProgram_.useProgram();
+	glUniform1i(shaderProgram_.getUniformLocation("texSampler"), 0);
+	countUniformUpload();
+	glActiveTexture(GL_TEXTURE0);
+	glBindVertexArray(vao_);
+	
+	for (const Batch& batch : batches_) {
+		glBindTexture(GL_TEXTURE_2D, batch.textureID);
+		glDrawElements(GL_TRIANGLES, batch.quadCount * 6, GL_UNSIGNED_INT,
+			(GLvoid*)(batch.firstQuad * 6 * sizeof(GLuint)));
+		countTextureBind();
+		countDrawCall(batch.quadCount * 2);
+	}
+	
+	glBindVertexArray(0);
+	
+	pendingQuadCount_ += spriteCount_;
+	pendingDrawCallCount_ += batches_.size();
+	
+	// The vertex memory can be reused, the data has been copied
+	spriteCount_ = 0;
+	batches_.clear();
+}
+
+} // end namespace bdEngine
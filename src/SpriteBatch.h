@@ -0,0 +1,151 @@
+#ifndef _BDENGINE_SPRITEBATCH_H
+#define _BDENGINE_SPRITEBATCH_H
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "FrameAllocator.h"
+#include "GLShaderProgram.h"
+#include "Math.h"
+#include "MemoryStats.h"
+#include "TextureManager.h"
+
+namespace bdEngine {
+
+/*!
+ * Component drawing a textured rectangle (centered on the origin of the
+ * entity's transform) in the xy plane.
+ */
+struct Sprite {
+	TextureHandle texture;
+	Vec2 size {1.0f, 1.0f};
+	
+	// Texture coordinates of the bottom left and top right corner
+	Vec2 uvMin {0.0f, 0.0f};
+	Vec2 uvMax {1.0f, 1.0f};
+	
+	// Tint color (RGBA, 8 bits each, red in the lowest byte)
+	std::uint32_t color = 0xFFFFFFFF;
+};
+
+/*!
+ * Vertex of a sprite quad, in world space.
+ */
+struct SpriteVertex {
+	float x, y, z;
+	float u, v;
+	std::uint32_t color;
+};
+
+/*!
+ * Collects textured quads and draws them with as few draw calls as possible.
+ *
+ * Vertices are written to frame memory and uploaded to one streamed vertex
+ * buffer in end(). Consecutive quads with the same texture are drawn with
+ * one call, so callers should submit sprites grouped by texture where the
+ * drawing order allows it. Uses the FrameData uniform block for the camera.
+ */
+class SpriteBatch {
+public:
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates the buffers for up to maxSprites quads per draw (more quads
+	 * are drawn in several rounds).
+	 */
+	explicit SpriteBatch(FrameAllocator& frameAllocator, std::size_t maxSprites = 16384);
+	~SpriteBatch();
+	
+	// --- Forbid copy and move operations
+	SpriteBatch(const SpriteBatch& other)            = delete;  // copy constructor
+	SpriteBatch& operator=(const SpriteBatch& other) = delete;  // copy assignment
+	SpriteBatch(SpriteBatch&& other)                 = delete;  // move constructor
+	SpriteBatch& operator=(SpriteBatch&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Drawing
+	 *******************************************************************/
+	/*!
+	 * Starts collecting quads.
+	 */
+	void begin();
+	
+	/*!
+	 * Adds a sprite of the given size, transformed by a world matrix.
+	 */
+	void draw(GLuint textureID, const Mat4& transform, const Sprite& sprite);
+	
+	/*!
+	 * Adds a quad with the given corners (counter-clockwise, starting at
+	 * the bottom left).
+	 */
+	void drawQuad(GLuint textureID, const SpriteVertex* corners);
+	
+	/*!
+	 * Draws all quads collected since begin().
+	 */
+	void end();
+	
+	
+	/*******************************************************************
+	 * Properties
+	 *******************************************************************/
+	/*!
+	 * Returns the number of quads drawn by the last end().
+	 */
+	std::size_t getQuadCount() const {
+		return quadCount_;
+	}
+	
+	/*!
+	 * Returns the number of draw calls issued by the last end().
+	 */
+	std::size_t getDrawCallCount() const {
+		return drawCallCount_;
+	}
+
+private:
+	// Quads sharing a texture
+	struct Batch {
+		GLuint textureID;
+		std::uint32_t firstQuad;
+		std::uint32_t quadCount;
+	};
+	
+	// Returns room for the four vertices of the next quad
+	SpriteVertex* addQuad(GLuint textureID);
+	
+	// Uploads and draws the collected quads, and starts over
+	void flush();
+	
+	// Frame memory for vertices
+	FrameAllocator& frameAllocator_;
+	std::size_t maxSprites_;
+	
+	// Collected quads of the current round
+	SpriteVertex* vertices_ = nullptr;
+	std::size_t spriteCount_ = 0;
+	std::vector<Batch, TrackingAllocator<Batch, MemoryTag::Renderer>> batches_;
+	
+	// Statistics of the last end()
+	std::size_t quadCount_ = 0;
+	std::size_t drawCallCount_ = 0;
+	std::size_t pendingQuadCount_ = 0;
+	std::size_t pendingDrawCallCount_ = 0;
+	
+	// GL objects
+	GLShaderProgram shaderProgram_;
+	GLuint vao_ = 0;
+	GLuint vbo_ = 0;
+	GLuint ebo_ = 0;
+	std::size_t bufferBytes_ = 0;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_SPRITEBATCH_H */
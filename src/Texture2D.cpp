@@ -1,9 +1,44 @@
 #include "Texture2D.h"
 
+#include <algorithm>
 #include <stdexcept>
 
+#include "MemoryStats.h"
+
 namespace bdEngine {
 
+/*******************************************************************
+ * Internal helpers
+ *******************************************************************/
+
+namespace {
+	// GL texture formats for tightly packed 8 bit RGB or RGBA pixels
+	GLenum internalFormatFor(int channels) {
+		return (channels == 4 ? GL_RGBA8 : GL_RGB8);
+	}
+	
+	GLenum formatFor(int channels) {
+		return (channels == 4 ? GL_RGBA : GL_RGB);
+	}
+	
+	// Estimated GPU memory of one level (drivers usually pad RGB to 4 bytes per texel)
+	std::size_t estimateLevelBytes(int width, int height) {
+		return std::size_t(width) * height * 4;
+	}
+	
+	// Estimated GPU memory of a full mip chain generated by the driver
+	std::size_t estimateMipmappedBytes(int width, int height) {
+		std::size_t bytes = estimateLevelBytes(width, height);
+		while (width > 1 || height > 1) {
+			width = std::max(1, width / 2);
+			height = std::max(1, height / 2);
+			bytes += estimateLevelBytes(width, height);
+		}
+		return bytes;
+	}
+}
+
+
 /*******************************************************************
  * Construction and destruction
  *******************************************************************/
@@ -26,12 +61,55 @@ Texture2D::Texture2D(Image& srcImage) {
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 	
 	// Generate texture image and mipmaps
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, srcImage.getWidth(), srcImage.getHeight(), 0,
-		GL_RGB, GL_UNSIGNED_BYTE, srcImage.getData());
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormatFor(srcImage.getChannels()), srcImage.getWidth(), srcImage.getHeight(), 0,
+		formatFor(srcImage.getChannels()), GL_UNSIGNED_BYTE, srcImage.getData());
 	glGenerateMipmap(GL_TEXTURE_2D);
 	
 	// Unbind
 	glBindTexture(GL_TEXTURE_2D, 0);
+	
+	gpuBytes = estimateMipmappedBytes(srcImage.getWidth(), srcImage.getHeight());
+	trackAllocation(MemoryTag::TextureGPU, gpuBytes);
+}
+
+// Constructor (CPU generated mipmaps)
+Texture2D::Texture2D(const MipChain& mipChain, std::size_t firstLevel) {
+	if (firstLevel >= mipChain.getLevelCount()) {
+		throw std::invalid_argument("Cannot create texture from an empty mip chain.");
+	}
+	
+	// Generate and bind GL texture object
+	glGenTextures(1, &textureID);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	
+	// Set texture parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	
+	// Set texture filtering (trilinear, all levels are provided)
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(mipChain.getLevelCount() - 1 - firstLevel));
+	
+	// Set alignment to fix glitches for images with row sizes that are not multiples of 4
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	
+	// Upload texture image level by level
+	GLenum internalFormat = internalFormatFor(mipChain.getChannels());
+	GLenum format = formatFor(mipChain.getChannels());
+	
+	for (std::size_t i = firstLevel; i < mipChain.getLevelCount(); ++i) {
+		const MipChain::Level& level = mipChain.getLevel(i);
+		glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i - firstLevel), internalFormat, level.width, level.height, 0,
+			format, GL_UNSIGNED_BYTE, level.data.data());
+		gpuBytes += estimateLevelBytes(level.width, level.height);
+	}
+	
+	// Unbind
+	glBindTexture(GL_TEXTURE_2D, 0);
+	
+	trackAllocation(MemoryTag::TextureGPU, gpuBytes);
 }
 
 // Destructor
@@ -40,15 +118,20 @@ Texture2D::~Texture2D() {
 		// Delete texture object in GPU
 		glDeleteTextures(1, &textureID);
 	}
+	if (gpuBytes != 0) {
+		trackDeallocation(MemoryTag::TextureGPU, gpuBytes);
+	}
 }
 
 // Move constructor
 Texture2D::Texture2D(Texture2D&& other) {
 	// Copy texture ID from other object so the new object owns the resource
 	textureID = other.textureID;
+	gpuBytes = other.gpuBytes;
 	
 	// Reset other object so that the destructor delete the texture object
 	other.textureID = 0;
+	other.gpuBytes = 0;
 }
 
 // Move assignment
@@ -56,12 +139,17 @@ Texture2D& Texture2D::operator=(Texture2D&& other) {
 	if (this != &other) {
 		// First, destroy the current object by deleting its texture object
 		glDeleteTextures(1, &textureID);
+		if (gpuBytes != 0) {
+			trackDeallocation(MemoryTag::TextureGPU, gpuBytes);
+		}
 	
 		// Now, copy data from source object
 		textureID = other.textureID;
+		gpuBytes = other.gpuBytes;
 		
 		// Reset other object so that the destructor delete the texture object
 		other.textureID = 0;
+		other.gpuBytes = 0;
 	}
 	
 	return *this;
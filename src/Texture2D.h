@@ -4,6 +4,7 @@
 #include <GL/glew.h>
 
 #include "Image.h"
+#include "MipChain.h"
 
 namespace bdEngine {
 
@@ -23,6 +24,13 @@ public:
 	 */
 	Texture2D(Image& srcImage);
 	
+	/*!
+	 * Creates texture from a mip chain generated on the CPU. All levels
+	 * starting at firstLevel are uploaded one by one, no mipmaps are
+	 * generated by the driver.
+	 */
+	Texture2D(const MipChain& mipChain, std::size_t firstLevel = 0);
+	
 	/*!
 	 * Releases texture resources.
 	 */
@@ -47,9 +55,20 @@ public:
 		return textureID;
 	}
 	
+	/*!
+	 * Returns the estimated GPU memory used by the texture in bytes (also
+	 * recorded as MemoryTag::TextureGPU).
+	 */
+	std::size_t getGPUBytes() const {
+		return gpuBytes;
+	}
+	
 private:
 	// GL texture object ID
-	GLuint textureID;
+	GLuint textureID = 0;
+	
+	// Estimated GPU memory
+	std::size_t gpuBytes = 0;
 };
 
 } // end namespace bdEngine
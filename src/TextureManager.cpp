@@ -0,0 +1,264 @@
+#include "TextureManager.h"
+#include "ResourceCache.h"
+
+#include <algorithm>
+#include <exception>
+
+// TODO implement own logging class
+#include <iostream>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+TextureManager::TextureManager(JobSystem& jobSystem, std::size_t budgetBytes, std::size_t maxTextures)
+	: jobSystem_ (jobSystem)
+	, entries_ {maxTextures}
+	, loadQueue_ {std::make_shared<LoadQueue>()}
+	, budgetBytes_ {budgetBytes}
+{
+}
+
+// Destructor
+TextureManager::~TextureManager() {
+	// Textures are released with the pool. Load jobs still running
+	// only hold references to the load queue (and its image allocator),
+	// not to this object.
+}
+
+
+/*******************************************************************
+ * Textures
+ *******************************************************************/
+
+TextureHandle TextureManager::load(const std::string& filename, MipFilter filter) {
+	// Return existing entry if the file is already loaded with this filter
+	// (by any spelling of its path)
+	std::string path = ResourceCache::normalizePath(filename);
+	std::string key = makeKey(path, filter);
+	auto it = entriesByKey_.find(key);
+	if (it != entriesByKey_.end()) {
+		return it->second;
+	}
+	
+	// Create new entry and start loading it
+	TextureHandle handle = entries_.create();
+	Entry& entry = *entries_.get(handle);
+	entry.filename = path;
+	entry.filter = filter;
+	entriesByKey_[key] = handle;
+	
+	startLoad(handle, 0);
+	
+	return handle;
+}
+
+void TextureManager::release(TextureHandle handle) {
+	Entry* entry = entries_.get(handle);
+	if (entry == nullptr) {
+		return;
+	}
+	
+	// Pending load results of the entry are dropped in update(), as the
+	// handle is stale by then.
+	evict(*entry);
+	entriesByKey_.erase(makeKey(entry->filename, entry->filter));
+	entries_.destroy(handle);
+}
+
+const Texture2D* TextureManager::get(TextureHandle handle) {
+	Entry* entry = entries_.get(handle);
+	if (entry == nullptr) {
+		return nullptr;
+	}
+	
+	entry->lastUsedFrame = currentFrame_;
+	
+	if (!isResident(*entry) && !entry->loading && !entry->failed) {
+		// Texture has been evicted, bring it back
+		startLoad(handle, entry->droppedLevels);
+	}
+	
+	return isResident(*entry) ? &entry->texture : nullptr;
+}
+
+void TextureManager::update() {
+	// -- Upload textures that finished loading
+	std::vector<LoadResult> results;
+	{
+		std::lock_guard<std::mutex> lock {loadQueue_->mutex};
+		results.swap(loadQueue_->results);
+	}
+	
+	for (auto& result : results) {
+		Entry* entryPtr = entries_.get(result.handle);
+		if (entryPtr == nullptr || entryPtr->generation != result.generation) {
+			// Texture has been released or evicted in the meantime
+			continue;
+		}
+		
+		Entry& entry = *entryPtr;
+		entry.loading = false;
+		
+		if (result.mipChain == nullptr) {
+			std::cerr << "Failed to load texture '" << entry.filename << "': " << result.error << std::endl;
+			entry.failed = true;
+			continue;
+		}
+		
+		// Replace current texture (if any) by the new one
+		evict(entry);
+		
+		entry.levelCount = result.mipChain->getLevelCount();
+		entry.droppedLevels = std::min(result.droppedLevels, entry.levelCount - 1);
+		entry.texture = Texture2D {*result.mipChain, entry.droppedLevels};
+		entry.residentBytes = estimateSize(*result.mipChain, entry.droppedLevels);
+		residentBytes_ += entry.residentBytes;
+	}
+	
+	// -- Evict least recently used textures that were not used in this frame
+	while (residentBytes_ > budgetBytes_) {
+		Entry* lruEntry = nullptr;
+		
+		for (auto& entry : entries_) {
+			if (isResident(entry) && entry.lastUsedFrame < currentFrame_
+				&& (lruEntry == nullptr || entry.lastUsedFrame < lruEntry->lastUsedFrame))
+			{
+				lruEntry = &entry;
+			}
+		}
+		
+		if (lruEntry == nullptr) {
+			break;
+		}
+		evict(*lruEntry);
+	}
+	
+	// Resident textures that could be reloaded with more or less mip levels,
+	// least recently used first
+	// (Positions in the pool, which don't change until the end of update().)
+	std::vector<std::size_t> candidates;
+	for (std::size_t i = 0; i < entries_.size(); ++i) {
+		if (isResident(entries_[i]) && !entries_[i].loading) {
+			candidates.push_back(i);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [this](std::size_t a, std::size_t b) {
+		return entries_[a].lastUsedFrame < entries_[b].lastUsedFrame;
+	});
+	
+	if (residentBytes_ > budgetBytes_) {
+		// -- Everything resident is in use: drop the top mip level of the
+		// least recently used textures until the expected savings suffice.
+		// (Each level is a quarter of the size of the one above it.)
+		std::size_t excessBytes = residentBytes_ - budgetBytes_;
+		std::size_t savedBytes = 0;
+		
+		for (std::size_t index : candidates) {
+			if (savedBytes >= excessBytes) {
+				break;
+			}
+			
+			Entry& entry = entries_[index];
+			if (entry.droppedLevels + 1 < entry.levelCount) {
+				startLoad(entries_.getHandle(index), entry.droppedLevels + 1);
+				savedBytes += entry.residentBytes * 3 / 4;
+			}
+		}
+	}
+	else {
+		// -- Restore dropped mip levels of textures used recently, most
+		// recently used first, keeping 10% of the budget free to avoid
+		// dropping and restoring the same levels over and over again.
+		std::size_t targetBytes = budgetBytes_ - budgetBytes_ / 10;
+		std::size_t plannedBytes = residentBytes_;
+		
+		for (auto it = candidates.rbegin(); it != candidates.rend(); ++it) {
+			Entry& entry = entries_[*it];
+			if (entry.droppedLevels == 0 || entry.lastUsedFrame + 1 < currentFrame_) {
+				continue;
+			}
+			
+			std::size_t extraBytes = entry.residentBytes * 3;
+			if (plannedBytes + extraBytes > targetBytes) {
+				break;
+			}
+			
+			startLoad(entries_.getHandle(*it), entry.droppedLevels - 1);
+			plannedBytes += extraBytes;
+		}
+	}
+	
+	++currentFrame_;
+}
+
+
+/*******************************************************************
+ * Properties
+ *******************************************************************/
+
+std::size_t TextureManager::estimateSize(const MipChain& mipChain, std::size_t firstLevel) {
+	// Drivers usually pad RGB textures to 4 bytes per texel
+	std::size_t size = 0;
+	for (std::size_t i = firstLevel; i < mipChain.getLevelCount(); ++i) {
+		const MipChain::Level& level = mipChain.getLevel(i);
+		size += static_cast<std::size_t>(level.width) * level.height * 4;
+	}
+	return size;
+}
+
+
+/*******************************************************************
+ * Internal helpers
+ *******************************************************************/
+
+std::string TextureManager::makeKey(const std::string& path, MipFilter filter) {
+	return path + (filter == MipFilter::Kaiser ? "|kaiser" : "|box");
+}
+
+void TextureManager::startLoad(TextureHandle handle, std::size_t droppedLevels) {
+	Entry& entry = *entries_.get(handle);
+	entry.loading = true;
+	
+	std::uint32_t generation = entry.generation;
+	std::string filename = entry.filename;
+	MipFilter filter = entry.filter;
+	std::shared_ptr<LoadQueue> loadQueue = loadQueue_;
+	
+	jobSystem_.submit([handle, generation, droppedLevels, filename, filter, loadQueue]() {
+		LoadResult result {handle, generation, droppedLevels, nullptr, {}};
+		
+		try {
+			// The decoded image (QOI only, SOIL allocates PNGs itself) and
+			// the filter buffers only live until the mip chain is built, its
+			// levels until the upload in update(). All of them go right back
+			// to the pool.
+			Image image {filename.c_str(), loadQueue->imageAllocator};
+			result.mipChain = std::make_unique<MipChain>(image, filter, nullptr, loadQueue->imageAllocator);
+		}
+		catch (std::exception& e) {
+			result.error = e.what();
+		}
+		
+		std::lock_guard<std::mutex> lock {loadQueue->mutex};
+		loadQueue->results.push_back(std::move(result));
+	});
+}
+
+void TextureManager::evict(Entry& entry) {
+	// A load still in flight would bring the texture back: make its result
+	// stale (get() starts a new one when the texture is needed again)
+	++entry.generation;
+	entry.loading = false;
+	
+	if (isResident(entry)) {
+		residentBytes_ -= entry.residentBytes;
+		entry.residentBytes = 0;
+		entry.texture = Texture2D {};
+	}
+}
+
+} // end namespace bdEngine
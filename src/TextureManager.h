@@ -0,0 +1,210 @@
+#ifndef _BDENGINE_TEXTUREMANAGER_H
+#define _BDENGINE_TEXTUREMANAGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ImageAllocator.h"
+#include "JobSystem.h"
+#include "MipChain.h"
+#include "Pool.h"
+#include "Texture2D.h"
+
+namespace bdEngine {
+
+/*!
+ * Handle to a texture owned by a TextureManager.
+ */
+using TextureHandle = PoolHandle<Texture2D>;
+
+/*!
+ * Owns textures and keeps their estimated GPU memory usage under a budget.
+ *
+ * Textures are loaded (decoded and mipmapped) in the background by the
+ * JobSystem and uploaded in update(), so a texture may not be resident right
+ * after load(). When the budget is exceeded, textures that were not used in
+ * the current frame are evicted (least recently used first). If that isn't
+ * enough, the least recently used textures are reloaded without their top mip
+ * level. Evicted textures are reloaded as soon as they are requested again,
+ * and dropped mip levels are restored when there is room in the budget.
+ *
+ * Textures are referenced by generational handles, so a handle of a released
+ * texture never refers to another texture that was loaded later.
+ *
+ * All functions must be called from the render thread.
+ */
+class TextureManager {
+public:
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates an empty texture manager with a GPU memory budget in bytes,
+	 * for at most maxTextures textures.
+	 */
+	TextureManager(JobSystem& jobSystem, std::size_t budgetBytes, std::size_t maxTextures = 4096);
+	
+	/*!
+	 * Releases all textures. Loads still in progress are discarded.
+	 */
+	~TextureManager();
+	
+	// --- Forbid copy and move operations
+	TextureManager(const TextureManager& other)            = delete;  // copy constructor
+	TextureManager& operator=(const TextureManager& other) = delete;  // copy assignment
+	TextureManager(TextureManager&& other)                 = delete;  // move constructor
+	TextureManager& operator=(TextureManager&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Textures
+	 *******************************************************************/
+	/*!
+	 * Registers a texture file and starts loading it in the background.
+	 * Loading the same file with the same filter twice returns the same
+	 * handle (see ResourceCache::normalizePath()), each filter gets a texture
+	 * of its own.
+	 */
+	TextureHandle load(const std::string& filename, MipFilter filter = MipFilter::Box);
+	
+	/*!
+	 * Releases a texture. The handle (and all copies of it) become invalid,
+	 * a load still in progress is discarded.
+	 */
+	void release(TextureHandle handle);
+	
+	/*!
+	 * Returns the texture of a handle and marks it as used in this frame.
+	 * Returns nullptr if the texture is not resident (yet), in which case it
+	 * is (re)loaded in the background, or if the handle has been released.
+	 * The pointer is only valid until the next call of load(), release() or
+	 * update().
+	 */
+	const Texture2D* get(TextureHandle handle);
+	
+	/*!
+	 * Uploads textures that finished loading and enforces the budget.
+	 * Has to be called once per frame, after all textures used in the frame
+	 * have been requested with get().
+	 */
+	void update();
+	
+	
+	/*******************************************************************
+	 * Properties
+	 *******************************************************************/
+	/*!
+	 * Returns the GPU memory budget in bytes.
+	 */
+	std::size_t getBudget() const {
+		return budgetBytes_;
+	}
+	
+	/*!
+	 * Sets the GPU memory budget in bytes. Takes effect on the next update().
+	 */
+	void setBudget(std::size_t budgetBytes) {
+		budgetBytes_ = budgetBytes;
+	}
+	
+	/*!
+	 * Returns the estimated GPU memory used by all resident textures.
+	 */
+	std::size_t getResidentBytes() const {
+		return residentBytes_;
+	}
+	
+	/*!
+	 * Returns the estimated GPU memory of a mip chain uploaded from firstLevel.
+	 */
+	static std::size_t estimateSize(const MipChain& mipChain, std::size_t firstLevel = 0);
+
+private:
+	// Managed texture
+	struct Entry {
+		std::string filename;
+		MipFilter filter;
+		
+		// Resident texture (texture ID 0 if evicted or not loaded yet)
+		Texture2D texture;
+		std::size_t residentBytes = 0;
+		
+		// Number of top mip levels left out of the resident texture
+		std::size_t droppedLevels = 0;
+		
+		// Number of mip levels (known after the first load)
+		std::size_t levelCount = 0;
+		
+		// Frame in which the texture was used last
+		std::uint64_t lastUsedFrame = 0;
+		
+		// A background load is in progress
+		bool loading = false;
+		
+		// Incremented on eviction, so results of loads started before are
+		// recognized as stale
+		std::uint32_t generation = 0;
+		
+		// Loading failed, don't try again
+		bool failed = false;
+	};
+	
+	// Result of a background load, handed over to update()
+	struct LoadResult {
+		TextureHandle handle;
+		std::uint32_t generation;
+		std::size_t droppedLevels;
+		std::unique_ptr<MipChain> mipChain;
+		std::string error;
+	};
+	
+	// Finished loads; shared with the load jobs so they may outlive the manager
+	struct LoadQueue {
+		// Recycles the image and mip chain buffers of the loads (declared
+		// first, so it outlives the results that still use its memory)
+		PooledImageAllocator imageAllocator;
+		
+		std::mutex mutex;
+		std::vector<LoadResult> results;
+	};
+	
+	// Returns the key of a normalized path and filter in entriesByKey_
+	static std::string makeKey(const std::string& path, MipFilter filter);
+	
+	// Returns true if the texture of an entry is resident
+	static bool isResident(const Entry& entry) {
+		return entry.texture.getTextureID() != 0;
+	}
+	
+	// Starts loading an entry in the background
+	void startLoad(TextureHandle handle, std::size_t droppedLevels);
+	
+	// Releases the texture of an entry and discards a load in progress
+	void evict(Entry& entry);
+	
+	// Job system for background loads
+	JobSystem& jobSystem_;
+	
+	// Managed textures
+	Pool<Entry, Texture2D> entries_;
+	std::unordered_map<std::string, TextureHandle> entriesByKey_;
+	
+	// Finished background loads
+	std::shared_ptr<LoadQueue> loadQueue_;
+	
+	// Budget and current usage in bytes
+	std::size_t budgetBytes_;
+	std::size_t residentBytes_ = 0;
+	
+	// Frame counter (incremented by update())
+	std::uint64_t currentFrame_ = 1;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_TEXTUREMANAGER_H */
@@ -0,0 +1,279 @@
+#include "Tilemap.h"
+#include "FrameUniforms.h"
+#include "MemoryStats.h"
+#include "RenderStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace bdEngine {
+
+const std::uint32_t TilemapLayer::chunkTiles;
+
+
+/*******************************************************************
+ * Constants, shader sources
+ *******************************************************************/
+
+// Vertex shader source code (after FrameUniforms::glslBlock)
+static const GLchar* tileVertexShaderSrc = R"__SRC__(
+
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 texCoord;
+
+out vec2 fragTexCoord;
+
+void main() {
+	gl_Position = viewProjection * vec4(position, 0.0, 1.0);
+	// Flip texture coordinates vertically because otherwise textures are upside down.
+	fragTexCoord = vec2(texCoord.x, 1 - texCoord.y);
+}
+
+)__SRC__";
+
+// Fragment shader source code
+static const GLchar* tileFragShaderSrc = R"__SRC__(
+#version 330 core
+
+in vec2 fragTexCoord;
+out vec4 color;
+
+uniform sampler2D tileset;
+
+void main() {
+	color = texture(tileset, fragTexCoord);
+}
+
+)__SRC__";
+
+namespace {
+	// Vertex of a tile quad, in world space
+	struct TileVertex {
+		float x, y;
+		float u, v;
+	};
+}
+
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+TilemapLayer::TilemapLayer(std::uint32_t width, std::uint32_t height, const Vec2& tileSize, const Vec2& origin,
+	TextureHandle tileset, std::uint32_t tilesetColumns, std::uint32_t tilesetRows)
+	: width_ {width}
+	, height_ {height}
+	, tiles_ (static_cast<std::size_t>(width) * height, 0)
+	, tileSize_ {tileSize}
+	, origin_ {origin}
+	, tileset_ {tileset}
+	, tilesetColumns_ {tilesetColumns}
+	, tilesetRows_ {tilesetRows}
+	, chunksX_ {(width + chunkTiles - 1) / chunkTiles}
+	, chunksY_ {(height + chunkTiles - 1) / chunkTiles}
+	, chunks_ (static_cast<std::size_t>(chunksX_) * chunksY_)
+{
+	if (tilesetColumns == 0 || tilesetRows == 0) {
+		throw std::invalid_argument("Tileset must not be empty.");
+	}
+	
+	// -- Compile and link shader program
+	const GLchar* vertexShaderSrcs[] = {FrameUniforms::glslBlock, tileVertexShaderSrc};
+	shaderProgram_.addShader(vertexShaderSrcs, GL_VERTEX_SHADER, 2);
+	shaderProgram_.addShader(&tileFragShaderSrc, GL_FRAGMENT_SHADER);
+	shaderProgram_.linkShaders();
+	shaderProgram_.bindUniformBlock(FrameUniforms::blockName, FrameUniforms::bindingPoint);
+	
+	// -- Indices for a full chunk (shorts are enough for 4096 vertices)
+	const std::uint32_t maxQuads = chunkTiles * chunkTiles;
+	std::vector<GLushort, TrackingAllocator<GLushort, MemoryTag::Renderer>> indices (maxQuads * 6);
+	for (std::uint32_t i = 0; i < maxQuads; ++i) {
+		GLushort base = static_cast<GLushort>(i * 4);
+		GLushort* quad = &indices[i * 6];
+		quad[0] = base;
+		quad[1] = base + 1;
+		quad[2] = base + 2;
+		quad[3] = base;
+		quad[4] = base + 2;
+		quad[5] = base + 3;
+	}
+	
+	glGenBuffers(1, &ebo_);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	trackAllocation(MemoryTag::BufferGPU, indices.size() * sizeof(GLushort));
+}
+
+// Destructor
+TilemapLayer::~TilemapLayer() {
+	for (Chunk& chunk : chunks_) {
+		if (chunk.vao) {
+			glDeleteVertexArrays(1, &chunk.vao);
+			glDeleteBuffers(1, &chunk.vbo);
+			trackDeallocation(MemoryTag::BufferGPU, chunk.bufferBytes);
+		}
+	}
+	
+	glDeleteBuffers(1, &ebo_);
+	trackDeallocation(MemoryTag::BufferGPU, chunkTiles * chunkTiles * 6 * sizeof(GLushort));
+}
+
+
+/*******************************************************************
+ * Tiles
+ *******************************************************************/
+
+void TilemapLayer::setTile(std::uint32_t x, std::uint32_t y, std::uint16_t tile) {
+	if (x >= width_ || y >= height_) {
+		throw std::out_of_range("Tile coordinates outside of the layer.");
+	}
+	
+	std::uint16_t& current = tiles_[static_cast<std::size_t>(y) * width_ + x];
+	if (current != tile) {
+		current = tile;
+		chunks_[(y / chunkTiles) * chunksX_ + x / chunkTiles].dirty = true;
+	}
+}
+
+std::uint16_t TilemapLayer::getTile(std::uint32_t x, std::uint32_t y) const {
+	if (x >= width_ || y >= height_) {
+		return 0;
+	}
+	return tiles_[static_cast<std::size_t>(y) * width_ + x];
+}
+
+
+/*******************************************************************
+ * Drawing
+ *******************************************************************/
+
+void TilemapLayer::draw(const Camera& camera, GLuint textureID) {
+	drawnChunkCount_ = 0;
+	rebuiltChunkCount_ = 0;
+	
+	// Range of chunks intersecting the view
+	Rect view = camera.getViewBounds();
+	const Vec2 chunkSize = tileSize_ * static_cast<float>(chunkTiles);
+	float x0 = std::floor((view.min.x - origin_.x) / chunkSize.x);
+	float y0 = std::floor((view.min.y - origin_.y) / chunkSize.y);
+	float x1 = std::floor((view.max.x - origin_.x) / chunkSize.x);
+	float y1 = std::floor((view.max.y - origin_.y) / chunkSize.y);
+	if (x1 < 0 || y1 < 0 || x0 >= chunksX_ || y0 >= chunksY_) {
+		return;
+	}
+	
+	std::uint32_t firstX = static_cast<std::uint32_t>(std::max(x0, 0.0f));
+	std::uint32_t firstY = static_cast<std::uint32_t>(std::max(y0, 0.0f));
+	std::uint32_t lastX = static_cast<std::uint32_t>(std::min(x1, static_cast<float>(chunksX_ - 1)));
+	std::uint32_t lastY = static_cast<std::uint32_t>(std::min(y1, static_cast<float>(chunksY_ - 1)));
+	
+	shaderProgram_.useProgram();
+	glUniform1i(shaderProgram_.getUniformLocation("tileset"), 0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	countUniformUpload();
+	countTextureBind();
+	
+	for (std::uint32_t cy = firstY; cy <= lastY; ++cy) {
+		for (std::uint32_t cx = firstX; cx <= lastX; ++cx) {
+			Chunk& chunk = chunks_[cy * chunksX_ + cx];
+			if (chunk.dirty) {
+				rebuildChunk(cx, cy);
+				++rebuiltChunkCount_;
+			}
+			if (chunk.indexCount == 0) {
+				continue;
+			}
+			
+			glBindVertexArray(chunk.vao);
+			glDrawElements(GL_TRIANGLES, chunk.indexCount, GL_UNSIGNED_SHORT, 0);
+			countDrawCall(chunk.indexCount / 3);
+			++drawnChunkCount_;
+		}
+	}
+	
+	glBindVertexArray(0);
+}
+
+
+/*******************************************************************
+ * Internal helpers
+ *******************************************************************/
+
+void TilemapLayer::rebuildChunk(std::uint32_t chunkX, std::uint32_t chunkY) {
+	Chunk& chunk = chunks_[chunkY * chunksX_ + chunkX];
+	chunk.dirty = false;
+	
+	// Quads for all non-empty tiles of the chunk
+	const float tileU = 1.0f / tilesetColumns_;
+	const float tileV = 1.0f / tilesetRows_;
+	std::vector<TileVertex, TrackingAllocator<TileVertex, MemoryTag::Renderer>> vertices;
+	vertices.reserve(chunkTiles * chunkTiles * 4);
+	
+	std::uint32_t endX = std::min((chunkX + 1) * chunkTiles, width_);
+	std::uint32_t endY = std::min((chunkY + 1) * chunkTiles, height_);
+	for (std::uint32_t y = chunkY * chunkTiles; y < endY; ++y) {
+		for (std::uint32_t x = chunkX * chunkTiles; x < endX; ++x) {
+			std::uint16_t tile = tiles_[static_cast<std::size_t>(y) * width_ + x];
+			if (tile == 0) {
+				continue;
+			}
+			
+			// Tileset cell, counted from the top left
+			std::uint32_t column = (tile - 1u) % tilesetColumns_;
+			std::uint32_t row = (tile - 1u) / tilesetColumns_;
+			float u0 = column * tileU;
+			float u1 = u0 + tileU;
+			float v1 = 1.0f - row * tileV;
+			float v0 = v1 - tileV;
+			
+			float px0 = origin_.x + x * tileSize_.x;
+			float py0 = origin_.y + y * tileSize_.y;
+			float px1 = px0 + tileSize_.x;
+			float py1 = py0 + tileSize_.y;
+			
+			vertices.push_back(TileVertex {px0, py0, u0, v0});
+			vertices.push_back(TileVertex {px1, py0, u1, v0});
+			vertices.push_back(TileVertex {px1, py1, u1, v1});
+			vertices.push_back(TileVertex {px0, py1, u0, v1});
+		}
+	}
+	
+	// Create the GL objects on first use, otherwise release the old buffer
+	if (chunk.vao) {
+		trackDeallocation(MemoryTag::BufferGPU, chunk.bufferBytes);
+	}
+	else {
+		glGenVertexArrays(1, &chunk.vao);
+		glGenBuffers(1, &chunk.vbo);
+		
+		glBindVertexArray(chunk.vao);
+		glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+		
+		// Set vertex attributes pointers:
+		// -> location 0: position
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(TileVertex), (GLvoid*)offsetof(TileVertex, x));
+		glEnableVertexAttribArray(0);
+		// -> location 1: texCoord
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TileVertex), (GLvoid*)offsetof(TileVertex, u));
+		glEnableVertexAttribArray(1);
+		
+		glBindVertexArray(0);
+	}
+	
+	// Replace the buffer contents
+	glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(TileVertex), vertices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	
+	chunk.bufferBytes = vertices.size() * sizeof(TileVertex);
+	trackAllocation(MemoryTag::BufferGPU, chunk.bufferBytes);
+	countUpload(vertices.size(), chunk.bufferBytes);
+	chunk.indexCount = static_cast<GLsizei>(vertices.size() / 4 * 6);
+}
+
+} // end namespace bdEngine
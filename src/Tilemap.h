@@ -0,0 +1,144 @@
+#ifndef _BDENGINE_TILEMAP_H
+#define _BDENGINE_TILEMAP_H
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Camera.h"
+#include "GLShaderProgram.h"
+#include "Math.h"
+#include "TextureManager.h"
+
+namespace bdEngine {
+
+/*!
+ * Layer of a tilemap: a grid of tiles taken from one tileset texture.
+ *
+ * Tiles are grouped into square chunks with one static vertex buffer each.
+ * A chunk's buffer is only rebuilt when one of its tiles changes, and only
+ * chunks in view of the camera are drawn (or rebuilt). Tile 0 is empty,
+ * tile n is the n-th cell of the tileset, counted row by row from the top
+ * left.
+ */
+class TilemapLayer {
+public:
+	/*! Width and height of a chunk in tiles. */
+	static const std::uint32_t chunkTiles = 32;
+	
+	
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates an empty layer of width x height tiles with the given size
+	 * in world units. Tile (0, 0) has its bottom left corner at origin, y
+	 * points up. The tileset has columns x rows tiles.
+	 */
+	TilemapLayer(std::uint32_t width, std::uint32_t height, const Vec2& tileSize, const Vec2& origin,
+		TextureHandle tileset, std::uint32_t tilesetColumns, std::uint32_t tilesetRows);
+	~TilemapLayer();
+	
+	// --- Forbid copy and move operations
+	TilemapLayer(const TilemapLayer& other)            = delete;  // copy constructor
+	TilemapLayer& operator=(const TilemapLayer& other) = delete;  // copy assignment
+	TilemapLayer(TilemapLayer&& other)                 = delete;  // move constructor
+	TilemapLayer& operator=(TilemapLayer&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Tiles
+	 *******************************************************************/
+	/*!
+	 * Sets a tile (marks its chunk for rebuilding if it changed). Throws
+	 * std::out_of_range for coordinates outside the layer.
+	 */
+	void setTile(std::uint32_t x, std::uint32_t y, std::uint16_t tile);
+	
+	/*!
+	 * Returns a tile (0 outside the layer).
+	 */
+	std::uint16_t getTile(std::uint32_t x, std::uint32_t y) const;
+	
+	std::uint32_t getWidth() const {
+		return width_;
+	}
+	
+	std::uint32_t getHeight() const {
+		return height_;
+	}
+	
+	TextureHandle getTileset() const {
+		return tileset_;
+	}
+	
+	
+	/*******************************************************************
+	 * Drawing
+	 *******************************************************************/
+	/*!
+	 * Draws all chunks in view of the camera with the given tileset texture
+	 * (uses the FrameData uniform block).
+	 */
+	void draw(const Camera& camera, GLuint textureID);
+	
+	/*!
+	 * Returns the number of chunks drawn by the last draw().
+	 */
+	std::size_t getDrawnChunkCount() const {
+		return drawnChunkCount_;
+	}
+	
+	/*!
+	 * Returns the number of chunks rebuilt by the last draw().
+	 */
+	std::size_t getRebuiltChunkCount() const {
+		return rebuiltChunkCount_;
+	}
+
+private:
+	// Static geometry of one chunk
+	struct Chunk {
+		GLuint vao = 0;
+		GLuint vbo = 0;
+		std::size_t bufferBytes = 0;
+		GLsizei indexCount = 0;
+		bool dirty = true;
+	};
+	
+	// Regenerates the vertex buffer of a chunk from its tiles
+	void rebuildChunk(std::uint32_t chunkX, std::uint32_t chunkY);
+	
+	// Tiles, row by row
+	std::uint32_t width_;
+	std::uint32_t height_;
+	std::vector<std::uint16_t> tiles_;
+	
+	// Placement
+	Vec2 tileSize_;
+	Vec2 origin_;
+	
+	// Tileset
+	TextureHandle tileset_;
+	std::uint32_t tilesetColumns_;
+	std::uint32_t tilesetRows_;
+	
+	// Chunks, row by row
+	std::uint32_t chunksX_;
+	std::uint32_t chunksY_;
+	std::vector<Chunk> chunks_;
+	
+	// GL objects shared by all chunks
+	GLShaderProgram shaderProgram_;
+	GLuint ebo_ = 0;
+	
+	// Statistics of the last draw()
+	std::size_t drawnChunkCount_ = 0;
+	std::size_t rebuiltChunkCount_ = 0;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_TILEMAP_H */
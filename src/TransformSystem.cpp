@@ -0,0 +1,310 @@
+#include "TransformSystem.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace bdEngine {
+
+const std::uint32_t TransformSystem::noIndex;
+
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+TransformSystem::TransformSystem(JobSystem* jobSystem)
+	: jobSystem_ {jobSystem}
+{
+}
+
+
+/*******************************************************************
+ * Nodes
+ *******************************************************************/
+
+TransformHandle TransformSystem::create(TransformHandle parent, const Transform& local) {
+	std::uint32_t parentIndex = (parent.isValid() ? getIndex(parent) : noIndex);
+	std::uint32_t depth = (parentIndex != noIndex ? depths_[parentIndex] + 1 : 0);
+	
+	// Reuse a free slot or append a new one
+	std::uint32_t slotIndex;
+	if (freeSlot_ != noIndex) {
+		slotIndex = freeSlot_;
+		freeSlot_ = slots_[slotIndex].nextFree;
+	}
+	else {
+		if (slots_.size() >= TransformHandle::indexMask) {
+			throw std::length_error("Too many transforms.");
+		}
+		slotIndex = static_cast<std::uint32_t>(slots_.size());
+		slots_.emplace_back();
+	}
+	
+	// Appending keeps the breadth-first order unless the node is less deep
+	// than the last one
+	if (!depths_.empty() && depth < depths_.back()) {
+		orderBroken_ = true;
+	}
+	
+	std::uint32_t index = static_cast<std::uint32_t>(parents_.size());
+	locals_.push_back(local);
+	worlds_.push_back(Mat4::identity());
+	parents_.push_back(parentIndex);
+	depths_.push_back(depth);
+	dirty_.push_back(1);
+	slotOfIndex_.push_back(slotIndex);
+	
+	Slot& slot = slots_[slotIndex];
+	slot.index = index;
+	slot.nextFree = noIndex;
+	
+	return TransformHandle {slotIndex, slot.generation};
+}
+
+void TransformSystem::destroy(TransformHandle handle) {
+	if (!contains(handle)) {
+		return;
+	}
+	
+	// Descendants come after their ancestors only in breadth-first order
+	if (orderBroken_) {
+		restoreOrder();
+	}
+	
+	// Mark the subtree in one pass (parents are marked before children)
+	std::uint32_t root = getIndex(handle);
+	std::vector<std::uint8_t> removed (parents_.size(), 0);
+	removed[root] = 1;
+	for (std::size_t i = root + 1; i < parents_.size(); ++i) {
+		removed[i] = (parents_[i] != noIndex && removed[parents_[i]]);
+	}
+	
+	// Compact the arrays, keeping the order
+	std::vector<std::uint32_t> newIndex (parents_.size(), noIndex);
+	std::uint32_t count = 0;
+	for (std::uint32_t i = 0; i < parents_.size(); ++i) {
+		Slot& slot = slots_[slotOfIndex_[i]];
+		
+		if (removed[i]) {
+			// Invalidate handles and put slot on the free list
+			slot.generation = (slot.generation + 1) & TransformHandle::generationMask;
+			slot.index = noIndex;
+			slot.nextFree = freeSlot_;
+			freeSlot_ = slotOfIndex_[i];
+			continue;
+		}
+		
+		newIndex[i] = count;
+		locals_[count] = locals_[i];
+		worlds_[count] = worlds_[i];
+		parents_[count] = (parents_[i] != noIndex ? newIndex[parents_[i]] : noIndex);
+		depths_[count] = depths_[i];
+		dirty_[count] = dirty_[i];
+		slotOfIndex_[count] = slotOfIndex_[i];
+		slot.index = count;
+		++count;
+	}
+	
+	locals_.resize(count);
+	worlds_.resize(count);
+	parents_.resize(count);
+	depths_.resize(count);
+	dirty_.resize(count);
+	slotOfIndex_.resize(count);
+}
+
+bool TransformSystem::contains(TransformHandle handle) const {
+	std::uint32_t slotIndex = handle.getIndex();
+	return handle.isValid() && slotIndex < slots_.size()
+		&& slots_[slotIndex].generation == handle.getGeneration()
+		&& slots_[slotIndex].index != noIndex;
+}
+
+void TransformSystem::setParent(TransformHandle handle, TransformHandle parent) {
+	std::uint32_t index = getIndex(handle);
+	std::uint32_t parentIndex = (parent.isValid() ? getIndex(parent) : noIndex);
+	
+	// The new parent must not be in the subtree of the node
+	for (std::uint32_t i = parentIndex; i != noIndex; i = parents_[i]) {
+		if (i == index) {
+			throw std::invalid_argument("Cannot make a transform a child of its own subtree.");
+		}
+	}
+	
+	parents_[index] = parentIndex;
+	dirty_[index] = 1;
+	
+	// Depths of the whole subtree change
+	orderBroken_ = true;
+}
+
+TransformHandle TransformSystem::getParent(TransformHandle handle) const {
+	std::uint32_t parentIndex = parents_[getIndex(handle)];
+	if (parentIndex == noIndex) {
+		return TransformHandle {};
+	}
+	
+	std::uint32_t slotIndex = slotOfIndex_[parentIndex];
+	return TransformHandle {slotIndex, slots_[slotIndex].generation};
+}
+
+
+/*******************************************************************
+ * Transformations
+ *******************************************************************/
+
+const Transform& TransformSystem::getLocal(TransformHandle handle) const {
+	return locals_[getIndex(handle)];
+}
+
+void TransformSystem::setLocal(TransformHandle handle, const Transform& local) {
+	std::uint32_t index = getIndex(handle);
+	locals_[index] = local;
+	dirty_[index] = 1;
+}
+
+void TransformSystem::setPosition(TransformHandle handle, const Vec3& position) {
+	std::uint32_t index = getIndex(handle);
+	locals_[index].position = position;
+	dirty_[index] = 1;
+}
+
+void TransformSystem::setRotation(TransformHandle handle, const Quat& rotation) {
+	std::uint32_t index = getIndex(handle);
+	locals_[index].rotation = rotation;
+	dirty_[index] = 1;
+}
+
+void TransformSystem::setScale(TransformHandle handle, const Vec3& scale) {
+	std::uint32_t index = getIndex(handle);
+	locals_[index].scale = scale;
+	dirty_[index] = 1;
+}
+
+const Mat4& TransformSystem::getWorldMatrix(TransformHandle handle) const {
+	return worlds_[getIndex(handle)];
+}
+
+void TransformSystem::update() {
+	if (orderBroken_) {
+		restoreOrder();
+	}
+	
+	// Levels larger than this are split across worker threads
+	const std::size_t parallelLevelSize = 4096;
+	const std::size_t grainSize = 1024;
+	
+	// Process level by level, so that the parents of a level are final
+	std::size_t begin = 0;
+	while (begin < parents_.size()) {
+		std::size_t end = begin + 1;
+		while (end < parents_.size() && depths_[end] == depths_[begin]) {
+			++end;
+		}
+		
+		if (jobSystem_ != nullptr && end - begin >= parallelLevelSize) {
+			jobSystem_->parallelFor(end - begin, grainSize, [this, begin](std::size_t first, std::size_t last) {
+				updateRange(begin + first, begin + last);
+			});
+		}
+		else {
+			updateRange(begin, end);
+		}
+		
+		begin = end;
+	}
+	
+	std::fill(dirty_.begin(), dirty_.end(), 0);
+}
+
+
+/*******************************************************************
+ * Internal helpers
+ *******************************************************************/
+
+std::uint32_t TransformSystem::getIndex(TransformHandle handle) const {
+	if (!contains(handle)) {
+		throw std::invalid_argument("Invalid transform handle.");
+	}
+	return slots_[handle.getIndex()].index;
+}
+
+void TransformSystem::restoreOrder() {
+	const std::size_t count = parents_.size();
+	
+	// Recompute depths by walking up to the first node with a known depth
+	std::vector<std::uint32_t> depths (count, noIndex);
+	std::vector<std::uint32_t> path;
+	for (std::uint32_t i = 0; i < count; ++i) {
+		std::uint32_t node = i;
+		while (node != noIndex && depths[node] == noIndex) {
+			path.push_back(node);
+			node = parents_[node];
+		}
+		
+		std::uint32_t depth = (node == noIndex ? 0 : depths[node] + 1);
+		while (!path.empty()) {
+			depths[path.back()] = depth++;
+			path.pop_back();
+		}
+	}
+	
+	// Sort by depth (stable, so siblings keep their relative order)
+	std::vector<std::uint32_t> order (count);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&depths](std::uint32_t a, std::uint32_t b) {
+		return depths[a] < depths[b];
+	});
+	
+	std::vector<std::uint32_t> newIndex (count);
+	for (std::uint32_t i = 0; i < count; ++i) {
+		newIndex[order[i]] = i;
+	}
+	
+	// Permute all arrays
+	std::vector<Transform> locals (count);
+	std::vector<Mat4> worlds (count);
+	std::vector<std::uint32_t> parents (count);
+	std::vector<std::uint8_t> dirty (count);
+	std::vector<std::uint32_t> slotOfIndex (count);
+	
+	for (std::uint32_t i = 0; i < count; ++i) {
+		std::uint32_t old = order[i];
+		locals[i] = locals_[old];
+		worlds[i] = worlds_[old];
+		parents[i] = (parents_[old] != noIndex ? newIndex[parents_[old]] : noIndex);
+		dirty[i] = dirty_[old];
+		slotOfIndex[i] = slotOfIndex_[old];
+		slots_[slotOfIndex[i]].index = i;
+		depths_[i] = depths[old];
+	}
+	
+	locals_.swap(locals);
+	worlds_.swap(worlds);
+	parents_.swap(parents);
+	dirty_.swap(dirty);
+	slotOfIndex_.swap(slotOfIndex);
+	orderBroken_ = false;
+}
+
+void TransformSystem::updateRange(std::size_t begin, std::size_t end) {
+	for (std::size_t i = begin; i < end; ++i) {
+		std::uint32_t parent = parents_[i];
+		
+		// Changes propagate down the hierarchy
+		if (parent != noIndex && dirty_[parent]) {
+			dirty_[i] = 1;
+		}
+		if (!dirty_[i]) {
+			continue;
+		}
+		
+		const Transform& local = locals_[i];
+		Mat4 localMatrix = Mat4::fromTRS(local.position, local.rotation, local.scale);
+		worlds_[i] = (parent != noIndex ? worlds_[parent] * localMatrix : localMatrix);
+	}
+}
+
+} // end namespace bdEngine
@@ -0,0 +1,177 @@
+#ifndef _BDENGINE_TRANSFORMSYSTEM_H
+#define _BDENGINE_TRANSFORMSYSTEM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "JobSystem.h"
+#include "Math.h"
+#include "Pool.h"
+
+namespace bdEngine {
+
+/*!
+ * Local transformation relative to the parent: scale, then rotation, then
+ * translation.
+ */
+struct Transform {
+	Vec3 position;
+	Quat rotation;
+	Vec3 scale {1.0f, 1.0f, 1.0f};
+};
+
+/*!
+ * Handle to a node of a TransformSystem.
+ */
+using TransformHandle = PoolHandle<Transform>;
+
+/*!
+ * Component linking an entity of a World to its transform node.
+ */
+struct TransformComponent {
+	TransformHandle handle;
+};
+
+/*!
+ * Hierarchy of transforms (scene graph) with cached world matrices.
+ *
+ * Nodes are stored in breadth-first order: sorted by depth, so every parent
+ * comes before its children. update() recomputes the world matrices in one
+ * linear pass over the arrays, level by level, and only for nodes whose local
+ * transform (or that of an ancestor) changed since the last update. Large
+ * levels are split across the threads of the job system.
+ *
+ * Adding nodes deeper than the last one or reparenting nodes restores the
+ * order on the next update().
+ */
+class TransformSystem {
+public:
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	/*!
+	 * Creates an empty hierarchy. If a job system is given, update() uses
+	 * it for large hierarchy levels.
+	 */
+	explicit TransformSystem(JobSystem* jobSystem = nullptr);
+	
+	// --- Forbid copy and move operations
+	TransformSystem(const TransformSystem& other)            = delete;  // copy constructor
+	TransformSystem& operator=(const TransformSystem& other) = delete;  // copy assignment
+	TransformSystem(TransformSystem&& other)                 = delete;  // move constructor
+	TransformSystem& operator=(TransformSystem&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Nodes
+	 *******************************************************************/
+	/*!
+	 * Creates a node with the given local transform below a parent (or as
+	 * a root if parent is invalid).
+	 */
+	TransformHandle create(TransformHandle parent = {}, const Transform& local = {});
+	
+	/*!
+	 * Destroys a node together with all its descendants.
+	 */
+	void destroy(TransformHandle handle);
+	
+	/*!
+	 * Returns true if the handle refers to an existing node.
+	 */
+	bool contains(TransformHandle handle) const;
+	
+	/*!
+	 * Moves a node (with its subtree) below another parent, or makes it a
+	 * root if parent is invalid. Throws std::invalid_argument if the new
+	 * parent is part of the subtree.
+	 */
+	void setParent(TransformHandle handle, TransformHandle parent);
+	
+	/*!
+	 * Returns the parent of a node (invalid for roots).
+	 */
+	TransformHandle getParent(TransformHandle handle) const;
+	
+	
+	/*******************************************************************
+	 * Transformations
+	 *******************************************************************/
+	/*!
+	 * Returns the local transform of a node.
+	 */
+	const Transform& getLocal(TransformHandle handle) const;
+	
+	/*!
+	 * Sets the local transform of a node.
+	 */
+	void setLocal(TransformHandle handle, const Transform& local);
+	
+	void setPosition(TransformHandle handle, const Vec3& position);
+	void setRotation(TransformHandle handle, const Quat& rotation);
+	void setScale(TransformHandle handle, const Vec3& scale);
+	
+	/*!
+	 * Returns the world matrix of a node as of the last update().
+	 */
+	const Mat4& getWorldMatrix(TransformHandle handle) const;
+	
+	/*!
+	 * Recomputes the world matrices of all changed nodes and their
+	 * descendants. Has to be called once per frame, before rendering.
+	 */
+	void update();
+	
+	
+	/*******************************************************************
+	 * Properties
+	 *******************************************************************/
+	/*!
+	 * Returns the number of nodes.
+	 */
+	std::size_t size() const {
+		return parents_.size();
+	}
+
+private:
+	static const std::uint32_t noIndex = 0xFFFFFFFF;
+	
+	// Indirection from handles to positions in the arrays
+	struct Slot {
+		std::uint32_t index = noIndex;
+		std::uint32_t generation = 0;
+		std::uint32_t nextFree = noIndex;
+	};
+	
+	// Returns the position of a node, throws if the handle is stale
+	std::uint32_t getIndex(TransformHandle handle) const;
+	
+	// Sorts the nodes by depth again after the order has been broken
+	void restoreOrder();
+	
+	// Recomputes world matrices of dirty nodes in [begin, end)
+	void updateRange(std::size_t begin, std::size_t end);
+	
+	// Job system for large levels (optional)
+	JobSystem* jobSystem_;
+	
+	// Node data in breadth-first order (parents_ holds positions)
+	std::vector<Transform> locals_;
+	std::vector<Mat4> worlds_;
+	std::vector<std::uint32_t> parents_;
+	std::vector<std::uint32_t> depths_;
+	std::vector<std::uint8_t> dirty_;
+	std::vector<std::uint32_t> slotOfIndex_;
+	
+	// Slots by handle index, and the head of the free slot list
+	std::vector<Slot> slots_;
+	std::uint32_t freeSlot_ = noIndex;
+	
+	// Nodes are not sorted by depth anymore
+	bool orderBroken_ = false;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_TRANSFORMSYSTEM_H */
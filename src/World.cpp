@@ -0,0 +1,302 @@
+#include "World.h"
+#include "MemoryStats.h"
+
+#include <mutex>
+#include <stdexcept>
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Component types
+ *******************************************************************/
+
+namespace {
+	// Registered component types (entries are written once before their
+	// ID is handed out, so reading them needs no lock)
+	struct ComponentRegistry {
+		std::mutex mutex;
+		std::array<ComponentInfo, maxComponentTypes> types;
+		std::size_t count = 0;
+	};
+	
+	ComponentRegistry& getRegistry() {
+		static ComponentRegistry registry;
+		return registry;
+	}
+	
+	// Rounds up to a multiple of the chunk column alignment (16 bytes, so
+	// that every component array is suitably aligned for SSE)
+	std::size_t alignColumn(std::size_t offset) {
+		return (offset + 15) & ~std::size_t(15);
+	}
+}
+
+ComponentTypeID registerComponentType(std::size_t size, std::size_t alignment) {
+	ComponentRegistry& registry = getRegistry();
+	std::lock_guard<std::mutex> lock {registry.mutex};
+	
+	if (registry.count >= maxComponentTypes) {
+		throw std::length_error("Too many component types.");
+	}
+	
+	registry.types[registry.count] = ComponentInfo {size, alignment};
+	return static_cast<ComponentTypeID>(registry.count++);
+}
+
+ComponentInfo getComponentInfo(ComponentTypeID id) {
+	return getRegistry().types[id];
+}
+
+
+/*******************************************************************
+ * Construction and destruction
+ *******************************************************************/
+
+// Constructor
+World::World() {
+	// Archetype 0 holds entities without components
+	getArchetype(0);
+}
+
+// Destructor
+World::~World() {
+	for (auto& archetype : archetypes_) {
+		for (std::size_t i = 0; i < archetype->chunks.size(); ++i) {
+			trackDeallocation(MemoryTag::Entities, chunkSize);
+		}
+	}
+}
+
+
+/*******************************************************************
+ * Entities
+ *******************************************************************/
+
+Entity World::createEntity() {
+	return createEntityIn(0);
+}
+
+void World::destroyEntity(Entity entity) {
+	EntityRecord* record = getRecord(entity);
+	if (record == nullptr) {
+		return;
+	}
+	
+	freeRow(*archetypes_[record->archetype], record->row);
+	
+	// Invalidate existing handles and put record on the free list
+	record->alive = false;
+	record->generation = (record->generation + 1) & Entity::generationMask;
+	record->nextFree = freeRecord_;
+	freeRecord_ = entity.getIndex();
+	--entityCount_;
+}
+
+bool World::isAlive(Entity entity) const {
+	return getRecord(entity) != nullptr;
+}
+
+
+/*******************************************************************
+ * Components
+ *******************************************************************/
+
+void* World::addComponent(Entity entity, ComponentTypeID type) {
+	EntityRecord* record = getRecord(entity);
+	if (record == nullptr) {
+		throw std::invalid_argument("Cannot add component to a destroyed entity.");
+	}
+	
+	std::uint64_t mask = archetypes_[record->archetype]->mask;
+	std::uint64_t typeBit = std::uint64_t(1) << type;
+	if ((mask & typeBit) == 0) {
+		moveEntity(entity, getArchetype(mask | typeBit));
+	}
+	
+	return archetypes_[record->archetype]->getComponent(record->row, type);
+}
+
+void World::removeComponent(Entity entity, ComponentTypeID type) {
+	EntityRecord* record = getRecord(entity);
+	if (record == nullptr) {
+		return;
+	}
+	
+	std::uint64_t mask = archetypes_[record->archetype]->mask;
+	std::uint64_t typeBit = std::uint64_t(1) << type;
+	if ((mask & typeBit) != 0) {
+		moveEntity(entity, getArchetype(mask & ~typeBit));
+	}
+}
+
+void* World::getComponent(Entity entity, ComponentTypeID type) {
+	EntityRecord* record = getRecord(entity);
+	if (record == nullptr) {
+		return nullptr;
+	}
+	
+	Archetype& archetype = *archetypes_[record->archetype];
+	if ((archetype.mask & (std::uint64_t(1) << type)) == 0) {
+		return nullptr;
+	}
+	return archetype.getComponent(record->row, type);
+}
+
+bool World::hasComponent(Entity entity, ComponentTypeID type) const {
+	const EntityRecord* record = getRecord(entity);
+	return record != nullptr && (archetypes_[record->archetype]->mask & (std::uint64_t(1) << type)) != 0;
+}
+
+
+/*******************************************************************
+ * Internal helpers
+ *******************************************************************/
+
+Entity World::createEntityIn(std::uint64_t mask) {
+	std::uint32_t archetypeIndex = getArchetype(mask);
+	
+	// Reuse a free record or append a new one
+	std::uint32_t index;
+	if (freeRecord_ != noRecord) {
+		index = freeRecord_;
+		freeRecord_ = records_[index].nextFree;
+	}
+	else {
+		if (records_.size() >= Entity::indexMask) {
+			throw std::length_error("Too many entities.");
+		}
+		index = static_cast<std::uint32_t>(records_.size());
+		records_.emplace_back();
+	}
+	
+	EntityRecord& record = records_[index];
+	Entity entity {index, record.generation};
+	record.alive = true;
+	record.archetype = archetypeIndex;
+	record.row = allocateRow(*archetypes_[archetypeIndex], entity);
+	++entityCount_;
+	
+	return entity;
+}
+
+std::uint32_t World::getArchetype(std::uint64_t mask) {
+	auto it = archetypesByMask_.find(mask);
+	if (it != archetypesByMask_.end()) {
+		return it->second;
+	}
+	
+	auto archetype = std::make_unique<Archetype>();
+	archetype->mask = mask;
+	
+	// Size of one row, with the entity handle
+	std::size_t rowSize = sizeof(Entity);
+	for (ComponentTypeID type = 0; type < maxComponentTypes; ++type) {
+		if (mask & (std::uint64_t(1) << type)) {
+			rowSize += getComponentInfo(type).size;
+		}
+	}
+	
+	// Find the largest capacity whose arrays (each padded for alignment)
+	// fit into a chunk
+	std::size_t capacity = chunkSize / rowSize;
+	while (capacity > 0) {
+		std::size_t offset = alignColumn(capacity * sizeof(Entity));
+		for (ComponentTypeID type = 0; type < maxComponentTypes; ++type) {
+			if (mask & (std::uint64_t(1) << type)) {
+				archetype->columnOffsets[type] = static_cast<std::uint16_t>(offset);
+				offset = alignColumn(offset + capacity * getComponentInfo(type).size);
+			}
+		}
+		if (offset <= chunkSize) {
+			break;
+		}
+		--capacity;
+	}
+	
+	if (capacity == 0) {
+		throw std::invalid_argument("Components of an entity don't fit into a chunk.");
+	}
+	archetype->chunkCapacity = capacity;
+	
+	std::uint32_t index = static_cast<std::uint32_t>(archetypes_.size());
+	archetypes_.push_back(std::move(archetype));
+	archetypesByMask_[mask] = index;
+	return index;
+}
+
+std::uint32_t World::allocateRow(Archetype& archetype, Entity entity) {
+	std::size_t row = archetype.count;
+	
+	// Start a new chunk if the last one is full
+	if (row == archetype.chunks.size() * archetype.chunkCapacity) {
+		archetype.chunks.emplace_back(new unsigned char[chunkSize]);
+		trackAllocation(MemoryTag::Entities, chunkSize);
+	}
+	
+	++archetype.count;
+	archetype.getEntities(row / archetype.chunkCapacity)[row % archetype.chunkCapacity] = entity;
+	return static_cast<std::uint32_t>(row);
+}
+
+void World::freeRow(Archetype& archetype, std::uint32_t row) {
+	std::size_t lastRow = archetype.count - 1;
+	
+	// Move the last row into the gap, so that all chunks stay packed
+	if (row != lastRow) {
+		Entity* lastEntity = &archetype.getEntities(lastRow / archetype.chunkCapacity)[lastRow % archetype.chunkCapacity];
+		archetype.getEntities(row / archetype.chunkCapacity)[row % archetype.chunkCapacity] = *lastEntity;
+		
+		for (ComponentTypeID type = 0; type < maxComponentTypes; ++type) {
+			if (archetype.mask & (std::uint64_t(1) << type)) {
+				std::memcpy(archetype.getComponent(row, type), archetype.getComponent(lastRow, type),
+					getComponentInfo(type).size);
+			}
+		}
+		
+		records_[lastEntity->getIndex()].row = row;
+	}
+	
+	--archetype.count;
+	
+	// Release the last chunk when it becomes empty
+	if (archetype.count == (archetype.chunks.size() - 1) * archetype.chunkCapacity) {
+		archetype.chunks.pop_back();
+		trackDeallocation(MemoryTag::Entities, chunkSize);
+	}
+}
+
+void World::moveEntity(Entity entity, std::uint32_t targetArchetype) {
+	EntityRecord& record = records_[entity.getIndex()];
+	Archetype& source = *archetypes_[record.archetype];
+	Archetype& target = *archetypes_[targetArchetype];
+	
+	// Copy the components both archetypes have
+	std::uint32_t row = allocateRow(target, entity);
+	std::uint64_t sharedMask = source.mask & target.mask;
+	for (ComponentTypeID type = 0; type < maxComponentTypes; ++type) {
+		if (sharedMask & (std::uint64_t(1) << type)) {
+			std::memcpy(target.getComponent(row, type), source.getComponent(record.row, type),
+				getComponentInfo(type).size);
+		}
+	}
+	
+	freeRow(source, record.row);
+	record.archetype = targetArchetype;
+	record.row = row;
+}
+
+World::EntityRecord* World::getRecord(Entity entity) {
+	std::uint32_t index = entity.getIndex();
+	if (!entity.isValid() || index >= records_.size()) {
+		return nullptr;
+	}
+	
+	EntityRecord& record = records_[index];
+	return (record.alive && record.generation == entity.getGeneration() ? &record : nullptr);
+}
+
+const World::EntityRecord* World::getRecord(Entity entity) const {
+	return const_cast<World*>(this)->getRecord(entity);
+}
+
+} // end namespace bdEngine
@@ -0,0 +1,376 @@
+#ifndef _BDENGINE_WORLD_H
+#define _BDENGINE_WORLD_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "JobSystem.h"
+#include "Pool.h"
+
+namespace bdEngine {
+
+/*******************************************************************
+ * Entities and components
+ *******************************************************************/
+
+struct EntityTag;
+
+/*!
+ * Handle to an entity of a World. Like pool handles, entity handles carry a
+ * generation, so handles of destroyed entities are detected.
+ */
+using Entity = PoolHandle<EntityTag>;
+
+/*!
+ * Numeric ID of a component type (0 <= ID < maxComponentTypes).
+ */
+using ComponentTypeID = std::uint32_t;
+
+const std::size_t maxComponentTypes = 64;
+
+/*!
+ * Size and alignment of a registered component type.
+ */
+struct ComponentInfo {
+	std::size_t size;
+	std::size_t alignment;
+};
+
+/*!
+ * Registers a component type and returns its ID. Use getComponentTypeID<T>().
+ * Throws std::length_error if there are too many component types.
+ */
+ComponentTypeID registerComponentType(std::size_t size, std::size_t alignment);
+
+/*!
+ * Returns size and alignment of a registered component type.
+ */
+ComponentInfo getComponentInfo(ComponentTypeID id);
+
+// Holds the ID of a component type (registered on first use)
+template <class T>
+struct ComponentType {
+	static_assert(std::is_trivially_copyable<T>::value, "Components have to be trivially copyable.");
+	static_assert(alignof(T) <= alignof(std::max_align_t), "Component alignment is too large.");
+	
+	static ComponentTypeID getID() {
+		static const ComponentTypeID id = registerComponentType(sizeof(T), alignof(T));
+		return id;
+	}
+};
+
+/*!
+ * Returns the ID of a component type (const T has the same ID as T).
+ * Components are plain data: they are moved around with memcpy and never
+ * destroyed, so they have to be trivially copyable.
+ */
+template <class T>
+ComponentTypeID getComponentTypeID() {
+	return ComponentType<typename std::remove_const<T>::type>::getID();
+}
+
+
+/*******************************************************************
+ * World
+ *******************************************************************/
+
+/*!
+ * Container of entities and their components (entity-component system).
+ *
+ * Entities with the same set of component types form an archetype. The
+ * components of an archetype are stored in chunks of 16 KiB, each chunk
+ * holding a fixed number of entities as one array per component type
+ * (structure of arrays). Queries like each<Position, Velocity>() visit the
+ * matching archetypes chunk by chunk and walk the component arrays linearly.
+ *
+ * Adding or removing components moves an entity to another archetype.
+ * Entities, components and archetypes must not be created or destroyed
+ * while iterating. A World is not thread-safe, except that parallelEach()
+ * runs the given function on several threads at once.
+ */
+class World {
+public:
+	/*!
+	 * Size of a chunk of component storage in bytes.
+	 */
+	static const std::size_t chunkSize = 16 * 1024;
+	
+	/*******************************************************************
+	 * Construction and destruction
+	 *******************************************************************/
+	World();
+	~World();
+	
+	// --- Forbid copy and move operations
+	World(const World& other)            = delete;  // copy constructor
+	World& operator=(const World& other) = delete;  // copy assignment
+	World(World&& other)                 = delete;  // move constructor
+	World& operator=(World&& other)      = delete;  // move assignment
+	
+	
+	/*******************************************************************
+	 * Entities
+	 *******************************************************************/
+	/*!
+	 * Creates an entity without components.
+	 */
+	Entity createEntity();
+	
+	/*!
+	 * Creates an entity with the given components (which need to be of
+	 * distinct types), without moving it through intermediate archetypes.
+	 */
+	template <class... Ts>
+	Entity createEntity(const Ts&... components) {
+		Entity entity = createEntityIn(getComponentMask<Ts...>());
+		int dummy[] = {0, (setComponent(entity, components), 0)...};
+		(void) dummy;
+		return entity;
+	}
+	
+	/*!
+	 * Destroys an entity with all its components. Does nothing if the
+	 * entity has already been destroyed.
+	 */
+	void destroyEntity(Entity entity);
+	
+	/*!
+	 * Returns true if the entity exists.
+	 */
+	bool isAlive(Entity entity) const;
+	
+	/*!
+	 * Returns the number of existing entities.
+	 */
+	std::size_t getEntityCount() const {
+		return entityCount_;
+	}
+	
+	
+	/*******************************************************************
+	 * Components
+	 *******************************************************************/
+	/*!
+	 * Adds a component to an entity, or overwrites it if the entity already
+	 * has a component of this type.
+	 */
+	template <class T>
+	void addComponent(Entity entity, const T& component = T {}) {
+		void* storage = addComponent(entity, getComponentTypeID<T>());
+		std::memcpy(storage, &component, sizeof(T));
+	}
+	
+	/*!
+	 * Removes a component from an entity (if it has one).
+	 */
+	template <class T>
+	void removeComponent(Entity entity) {
+		removeComponent(entity, getComponentTypeID<T>());
+	}
+	
+	/*!
+	 * Returns true if the entity has a component of type T.
+	 */
+	template <class T>
+	bool hasComponent(Entity entity) const {
+		return hasComponent(entity, getComponentTypeID<T>());
+	}
+	
+	/*!
+	 * Returns a component of an entity, or nullptr if the entity doesn't
+	 * have one (or doesn't exist). The pointer is invalidated by any
+	 * structural change of the world.
+	 */
+	template <class T>
+	T* getComponent(Entity entity) {
+		return static_cast<T*>(getComponent(entity, getComponentTypeID<T>()));
+	}
+	
+	
+	/*******************************************************************
+	 * Queries
+	 *******************************************************************/
+	/*!
+	 * Calls func(Ts&... components) for every entity that has all of the
+	 * component types Ts (and possibly others). Use const types for
+	 * components that are only read.
+	 */
+	template <class... Ts, class Func>
+	void each(Func&& func) {
+		const std::uint64_t mask = getComponentMask<Ts...>();
+		for (auto& archetype : archetypes_) {
+			if ((archetype->mask & mask) != mask) {
+				continue;
+			}
+			for (std::size_t chunk = 0; chunk < archetype->chunks.size(); ++chunk) {
+				forEachRow(archetype->getChunkCount(chunk), func, archetype->getColumn<Ts>(chunk)...);
+			}
+		}
+	}
+	
+	/*!
+	 * Like each(), but also passes the entity: func(Entity, Ts&...).
+	 */
+	template <class... Ts, class Func>
+	void eachEntity(Func&& func) {
+		const std::uint64_t mask = getComponentMask<Ts...>();
+		for (auto& archetype : archetypes_) {
+			if ((archetype->mask & mask) != mask) {
+				continue;
+			}
+			for (std::size_t chunk = 0; chunk < archetype->chunks.size(); ++chunk) {
+				forEachRow(archetype->getChunkCount(chunk), func,
+					archetype->getEntities(chunk), archetype->getColumn<Ts>(chunk)...);
+			}
+		}
+	}
+	
+	/*!
+	 * Like each(), but distributes the matching chunks over the threads of
+	 * a job system. func is called concurrently and must only touch the
+	 * components it is given (and thread-safe state).
+	 */
+	template <class... Ts, class Func>
+	void parallelEach(JobSystem& jobSystem, Func&& func) {
+		const std::uint64_t mask = getComponentMask<Ts...>();
+		
+		// Collect matching chunks first, then process one chunk per task
+		std::vector<std::pair<Archetype*, std::size_t>> chunks;
+		for (auto& archetype : archetypes_) {
+			if ((archetype->mask & mask) != mask) {
+				continue;
+			}
+			for (std::size_t chunk = 0; chunk < archetype->chunks.size(); ++chunk) {
+				chunks.emplace_back(archetype.get(), chunk);
+			}
+		}
+		
+		jobSystem.parallelFor(chunks.size(), 1, [&chunks, &func](std::size_t begin, std::size_t end) {
+			for (std::size_t i = begin; i < end; ++i) {
+				Archetype& archetype = *chunks[i].first;
+				std::size_t chunk = chunks[i].second;
+				forEachRow(archetype.getChunkCount(chunk), func, archetype.getColumn<Ts>(chunk)...);
+			}
+		});
+	}
+	
+	/*!
+	 * Returns the component mask (one bit per component type ID) of a set
+	 * of component types.
+	 */
+	template <class... Ts>
+	static std::uint64_t getComponentMask() {
+		std::uint64_t mask = 0;
+		int dummy[] = {0, (mask |= std::uint64_t(1) << getComponentTypeID<Ts>(), 0)...};
+		(void) dummy;
+		return mask;
+	}
+
+private:
+	// Entities with the same component types, stored in chunks
+	struct Archetype {
+		std::uint64_t mask = 0;
+		
+		// Entities per chunk, and byte offset of each component array
+		// within a chunk (indexed by component type ID, entities at 0)
+		std::size_t chunkCapacity = 0;
+		std::array<std::uint16_t, maxComponentTypes> columnOffsets {};
+		
+		std::vector<std::unique_ptr<unsigned char[]>> chunks;
+		std::size_t count = 0;
+		
+		// Returns the number of entities in a chunk
+		std::size_t getChunkCount(std::size_t chunk) const {
+			return std::min(chunkCapacity, count - chunk * chunkCapacity);
+		}
+		
+		// Returns the entity array of a chunk
+		Entity* getEntities(std::size_t chunk) {
+			return reinterpret_cast<Entity*>(chunks[chunk].get());
+		}
+		
+		// Returns the array of a component type in a chunk
+		template <class T>
+		T* getColumn(std::size_t chunk) {
+			return reinterpret_cast<T*>(chunks[chunk].get() + columnOffsets[getComponentTypeID<T>()]);
+		}
+		
+		// Returns the storage of a component of the entity in a row
+		unsigned char* getComponent(std::size_t row, ComponentTypeID type) {
+			return chunks[row / chunkCapacity].get() + columnOffsets[type]
+				+ (row % chunkCapacity) * getComponentInfo(type).size;
+		}
+	};
+	
+	// Location of an entity
+	struct EntityRecord {
+		std::uint32_t archetype = 0;
+		std::uint32_t row = 0;
+		std::uint32_t generation = 0;
+		std::uint32_t nextFree = 0;
+		bool alive = false;
+	};
+	
+	// Calls func for each row of some arrays
+	template <class Func, class... Ptrs>
+	static void forEachRow(std::size_t count, Func& func, Ptrs... arrays) {
+		for (std::size_t i = 0; i < count; ++i) {
+			func(arrays[i]...);
+		}
+	}
+	
+	// Writes a component of an entity that has one
+	template <class T>
+	void setComponent(Entity entity, const T& component) {
+		std::memcpy(getComponent(entity, getComponentTypeID<T>()), &component, sizeof(T));
+	}
+	
+	// Untyped component operations
+	void* addComponent(Entity entity, ComponentTypeID type);
+	void removeComponent(Entity entity, ComponentTypeID type);
+	void* getComponent(Entity entity, ComponentTypeID type);
+	bool hasComponent(Entity entity, ComponentTypeID type) const;
+	
+	// Creates an entity in the archetype of a mask (components uninitialized)
+	Entity createEntityIn(std::uint64_t mask);
+	
+	// Returns the index of the archetype of a mask, creating it if necessary
+	std::uint32_t getArchetype(std::uint64_t mask);
+	
+	// Appends a row for an entity to an archetype and returns the row
+	std::uint32_t allocateRow(Archetype& archetype, Entity entity);
+	
+	// Removes a row by moving the last row into it
+	void freeRow(Archetype& archetype, std::uint32_t row);
+	
+	// Moves an entity to another archetype, copying shared components
+	void moveEntity(Entity entity, std::uint32_t targetArchetype);
+	
+	// Returns the record of a live entity or nullptr
+	EntityRecord* getRecord(Entity entity);
+	const EntityRecord* getRecord(Entity entity) const;
+	
+	// Archetypes and the index of each by component mask
+	std::vector<std::unique_ptr<Archetype>> archetypes_;
+	std::unordered_map<std::uint64_t, std::uint32_t> archetypesByMask_;
+	
+	// Entity records by handle index, and the head of the free list
+	std::vector<EntityRecord> records_;
+	std::uint32_t freeRecord_ = noRecord;
+	std::size_t entityCount_ = 0;
+	
+	static const std::uint32_t noRecord = 0xFFFFFFFF;
+};
+
+} // end namespace bdEngine
+
+#endif /* end of include guard: _BDENGINE_WORLD_H */
@@ -15,6 +15,8 @@ int main(int argc, char* argv[]) {
 		std::cout << "Key bindings:" << std::endl;
 		std::cout << "Q: quit application" << std::endl;
 		std::cout << "F: toggle wireframe mode" << std::endl;
+		std::cout << "M: print memory statistics" << std::endl;
+		std::cout << "F3: toggle debug overlay" << std::endl;
 		// std::cout << "press k to turn left" << std::endl;
 		// std::cout << "press l to turn right" << std::endl;
 		std::cout << std::endl;